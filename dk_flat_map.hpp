@@ -1,16 +1,57 @@
 /**
- * \file dk_flat_map.hpp - v0.21
+ * \file dk_flat_map.hpp - v0.36
  * \author KOH Swee Teck Dedrick
  * \brief
  *      A flat map is an associative ordered container using a sorted vector.
  * 
  *      The container has a similar interface a std::map. It has O(n)
- *      insertion and erase, and O(lg n) lookup.
+ *      insertion and erase, and O(lg n) lookup. Being a sorted array, it also
+ *      answers rank queries in O(lg n) and selects by rank in O(1), and its
+ *      index iterators hold a rank that survives reallocation.
  * 
  *      A flat map is best used when insertions and deletions are rare and
  *      the container spend most of its time in lookups and iteration. It
  *      exploits the cache friendliness of the backing array.
  * 
+ *      The Growth parameter controls how the backing array grows on insert.
+ *      dk::ratio_growth<5, 4> caps the memory overhead of huge maps at 25%.
+ * 
+ *      Composite integer keys can be packed into a dk::packed_key, which
+ *      compares as a single 64-bit or 128-bit integer.
+ * 
+ *      When the value type is trivially relocatable (see
+ *      dk::is_trivially_relocatable) and the container is contiguous,
+ *      inserting or erasing a single element shifts the tail with a single
+ *      memmove instead of moving each element one by one.
+ * 
+ *      Very large maps can use dk::huge_page_allocator as the allocator of
+ *      the backing vector to reduce TLB misses during binary search.
+ * 
+ *      Frozen maps with 64-bit integer keys can be compressed into a
+ *      dk::elias_fano_map, which encodes keys in about 2 + log2(U / n) bits.
+ * 
+ *      Maps where most lookups miss can pass dk::blocked_bloom_filter as the
+ *      Filter parameter, answering most misses with one cache line access.
+ * 
+ *      Lookups with strong locality can go through a flat_map::cursor, which
+ *      gallops from the previous position instead of searching the whole map.
+ * 
+ *      dk::parallel_join merge-joins two large maps across a dk::thread_pool,
+ *      and dk::parallel_for_each, dk::parallel_transform_reduce and
+ *      dk::parallel_count_if scan a map or a key range on the same pool.
+ * 
+ *      dk::diff and dk::apply_patch replicate changes between two versions of
+ *      a map with one linear merge instead of per-key inserts and erases.
+ * 
+ *      dk::flat_interval_map maps half-open key ranges to values on top of the
+ *      same sorted storage, coalescing adjacent equal intervals.
+ * 
+ *      dk::sliding_flat_map keeps a window of keys appended in order and
+ *      expired from the front, erasing a prefix by advancing a head offset.
+ * 
+ *      Include dk_pcg32.h before this header to enable dk::random_entry,
+ *      dk::sample, dk::reservoir_sample and dk::weighted_sampler.
+ * 
  *  LICENSE
  *      License information at the end of the header.
  */
@@ -19,52 +60,775 @@
 #define DK_INCLUDE_DK_FLAT_MAP_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#if defined(__linux__)
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+#if !defined(DK_ASSERT)
+#   if defined(_MSC_VER)
+#       if !defined(NDEBUG)
+#           include <intrin.h>
+#           define DK_ASSERT(x) do { if (!(x)) { __debugbreak(); } } while(false) /* NOLINT */
+#       else
+#           define DK_ASSERT(x) do { if (!(x)) { (void)(sizeof(x)); } } while(false) /* NOLINT */
+#       endif
+#   else
+#       include <cassert>
+#       define DK_ASSERT(x) assert(x) /* NOLINT */
+#   endif
+#endif
+
+#if !defined(DK_IS_TRIVIALLY_RELOCATABLE_DEFINED)
+#define DK_IS_TRIVIALLY_RELOCATABLE_DEFINED
+namespace dk {
+    // NOTE(Dedrick): A type is trivially relocatable if moving it to a new address and
+    // abandoning the old storage is equivalent to a memcpy of its bytes. Trivially
+    // copyable types always are. Specialize this for other types to opt them in, e.g.
+    // std::unique_ptr or std::shared_ptr. Be careful with std::string, libstdc++ keeps a
+    // pointer into its own small string buffer and is NOT trivially relocatable.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+    template <typename A, typename B>
+    struct is_trivially_relocatable<std::pair<A, B>> :
+        std::bool_constant<
+            is_trivially_relocatable<A>::value &&
+            is_trivially_relocatable<B>::value> { };
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+}
+#endif // DK_IS_TRIVIALLY_RELOCATABLE_DEFINED
+
 namespace dk {
+    /**
+     * \brief An allocator for very large backing arrays. Allocations of at least
+     * huge_page_size bytes are 2 MB aligned and backed by huge pages where the
+     * platform supports it, smaller allocations are cache line aligned.
+     * 
+     * On Linux the memory is requested with madvise(MADV_HUGEPAGE) so transparent
+     * huge pages are used when enabled. Define DK_FLAT_MAP_USE_MAP_HUGETLB to try
+     * explicit MAP_HUGETLB pages first, falling back to madvise if the reserved
+     * pool is exhausted.
+     * 
+     * Because the base address is cache line aligned, entries whose size divides
+     * cache_line_size never straddle two cache lines. Other sizes, e.g. a 24 byte
+     * pair, do straddle and should be padded to 16, 32 or 64 bytes. Check
+     * is_line_aligned to catch this at compile-time.
+     * 
+     * \code
+     * using value = std::pair<std::uint64_t, std::uint64_t>;
+     * static_assert(dk::huge_page_allocator<value>::is_line_aligned);
+     * dk::flat_map<std::uint64_t, std::uint64_t, std::less<>,
+     *     std::vector<value, dk::huge_page_allocator<value>>> map;
+     * map.insert({ 1, 2 });
+     * std::size_t const page = map.get_allocator().page_size();
+     * \endcode
+     */
+    template <typename T>
+    class huge_page_allocator {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        static constexpr std::size_t huge_page_size = std::size_t{ 2 } * 1024 * 1024;
+        static constexpr std::size_t cache_line_size = 64;
+
+        // NOTE(Dedrick): True when no element straddles a cache line boundary, i.e. the
+        // element size divides the line or is a multiple of it.
+        static constexpr bool is_line_aligned =
+            cache_line_size % sizeof(T) == 0 || sizeof(T) % cache_line_size == 0;
+
+        template <typename U>
+        struct rebind {
+            using other = huge_page_allocator<U>;
+        };
+
+    private:
+        template <typename U>
+        friend class huge_page_allocator;
+
+        std::size_t m_page_size;
+
+    public:
+        huge_page_allocator() noexcept :
+            m_page_size{ 0 } { }
+
+        template <typename U>
+        huge_page_allocator(huge_page_allocator<U> const &rhs) noexcept :
+            m_page_size{ rhs.m_page_size } { }
+
+        /**
+         * \brief Gets the page size guaranteed to back the most recent allocation.
+         * This is huge_page_size only when explicit MAP_HUGETLB pages were mapped,
+         * the system page size otherwise, and 0 if it is not known.
+         * 
+         * \note Memory advised with MADV_HUGEPAGE reports the system page size,
+         * since the kernel backs it with transparent huge pages on a best-effort
+         * basis. AnonHugePages in /proc/self/smaps shows how much was granted.
+         */
+        [[nodiscard]] auto page_size() const noexcept -> std::size_t {
+            return m_page_size;
+        }
+
+        [[nodiscard]] auto allocate(std::size_t n) -> value_type* {
+            if (n > static_cast<std::size_t>(-1) / sizeof(value_type)) {
+                throw std::bad_array_new_length();
+            }
+            std::size_t const bytes = n * sizeof(value_type);
+            if (bytes < huge_page_size) {
+                m_page_size = system_page_size();
+                return static_cast<value_type *>(::operator new(bytes, align_val()));
+            }
+
+#if defined(__linux__)
+            std::size_t const length = round_up(bytes);
+#if defined(DK_FLAT_MAP_USE_MAP_HUGETLB) && defined(MAP_HUGETLB)
+            void *const huge = ::mmap(
+                nullptr, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (huge != MAP_FAILED) {
+                m_page_size = huge_page_size;
+                return static_cast<value_type *>(huge);
+            }
+#endif
+            // NOTE(Dedrick): Over-allocate by one huge page, then trim the head and tail
+            // so the mapping starts on a 2 MB boundary the kernel can back with huge pages.
+            std::size_t const padded = length + huge_page_size;
+            void *const raw = ::mmap(
+                nullptr, padded, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            auto const raw_addr = reinterpret_cast<std::uintptr_t>(raw);
+            auto const addr = (raw_addr + huge_page_size - 1) & ~(std::uintptr_t{ huge_page_size } - 1);
+            std::size_t const head = addr - raw_addr;
+            std::size_t const tail = padded - head - length;
+            if (head != 0) {
+                ::munmap(raw, head);
+            }
+            if (tail != 0) {
+                ::munmap(reinterpret_cast<void *>(addr + length), tail);
+            }
+
+            void *const ptr = reinterpret_cast<void *>(addr);
+#if defined(MADV_HUGEPAGE)
+            // NOTE(Dedrick): Success only means the advice was accepted, not that huge
+            // pages were granted, so the reported size stays the system page size.
+            ::madvise(ptr, length, MADV_HUGEPAGE);
+#endif
+            m_page_size = system_page_size();
+            return static_cast<value_type *>(ptr);
+#else
+            // NOTE(Dedrick): No portable huge page support, settle for a 2 MB aligned block.
+            m_page_size = 0;
+            return static_cast<value_type *>(::operator new(round_up(bytes), std::align_val_t{ huge_page_size }));
+#endif
+        }
+
+        auto deallocate(value_type *ptr, std::size_t n) noexcept -> void {
+            std::size_t const bytes = n * sizeof(value_type);
+            if (bytes < huge_page_size) {
+                ::operator delete(ptr, align_val());
+                return;
+            }
+#if defined(__linux__)
+            ::munmap(ptr, round_up(bytes));
+#else
+            ::operator delete(ptr, std::align_val_t{ huge_page_size });
+#endif
+        }
+
+    private:
+        static constexpr auto align_val() noexcept -> std::align_val_t {
+            return std::align_val_t{ alignof(value_type) > cache_line_size ? alignof(value_type) : cache_line_size };
+        }
+
+        static constexpr auto round_up(std::size_t bytes) noexcept -> std::size_t {
+            return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+        }
+
+        static auto system_page_size() noexcept -> std::size_t {
+#if defined(__linux__)
+            long const page = ::sysconf(_SC_PAGESIZE);
+            return page > 0 ? static_cast<std::size_t>(page) : 0;
+#else
+            return 0;
+#endif
+        }
+    };
+
+    template <typename T, typename U>
+    [[nodiscard]] auto operator==(huge_page_allocator<T> const &, huge_page_allocator<U> const &) noexcept -> bool {
+        return true;
+    }
+
+    template <typename T, typename U>
+    [[nodiscard]] auto operator!=(huge_page_allocator<T> const &, huge_page_allocator<U> const &) noexcept -> bool {
+        return false;
+    }
+
+    namespace detail {
+        template <typename Container, typename = void>
+        struct has_reserve : std::false_type { };
+
+        template <typename Container>
+        struct has_reserve<Container, std::void_t<
+            decltype(std::declval<Container&>().reserve(std::declval<typename Container::size_type>()))>> :
+            std::true_type { };
+
+        template <typename Container, typename = void>
+        struct has_capacity : std::false_type { };
+
+        template <typename Container>
+        struct has_capacity<Container, std::void_t<
+            decltype(std::declval<Container const&>().capacity())>> :
+            std::true_type { };
+
+        template <typename Container, typename = void>
+        struct has_shrink_to_fit : std::false_type { };
+
+        template <typename Container>
+        struct has_shrink_to_fit<Container, std::void_t<
+            decltype(std::declval<Container&>().shrink_to_fit())>> :
+            std::true_type { };
+
+        // NOTE(Dedrick): The hash of a hashing filter, void for filters that do not hash.
+        template <typename Filter, typename = void>
+        struct filter_hasher {
+            using type = void;
+        };
+
+        template <typename Filter>
+        struct filter_hasher<Filter, std::void_t<typename Filter::hasher>> {
+            using type = typename Filter::hasher;
+        };
+
+        template <typename T>
+        struct is_pair : std::false_type { };
+
+        template <typename A, typename B>
+        struct is_pair<std::pair<A, B>> : std::true_type { };
+
+        template <typename T>
+        inline constexpr bool is_pair_v = is_pair<T>::value;
+
+        template <typename Container, typename = void>
+        struct is_contiguous_container : std::false_type { };
+
+        template <typename Container>
+        struct is_contiguous_container<Container, std::void_t<
+            decltype(std::declval<Container&>().data()),
+            decltype(std::declval<Container&>().capacity()),
+            decltype(std::declval<Container&>().pop_back())>> :
+            std::is_same<
+                decltype(std::declval<Container&>().data()),
+                typename Container::value_type*> { };
+
+        [[nodiscard]] inline auto popcount(std::uint64_t x) noexcept -> int {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(x);
+#else
+            x = x - ((x >> 1) & 0x5555555555555555ull);
+            x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+            x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+            return static_cast<int>((x * 0x0101010101010101ull) >> 56);
+#endif
+        }
+
+        // NOTE(Dedrick): x must be non-zero.
+        [[nodiscard]] inline auto count_trailing_zeros(std::uint64_t x) noexcept -> int {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(x);
+#else
+            return popcount((x & (0 - x)) - 1);
+#endif
+        }
+
+        // NOTE(Dedrick): x must be non-zero.
+        [[nodiscard]] inline auto count_leading_zeros(std::uint64_t x) noexcept -> int {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_clzll(x);
+#else
+            x |= x >> 1;
+            x |= x >> 2;
+            x |= x >> 4;
+            x |= x >> 8;
+            x |= x >> 16;
+            x |= x >> 32;
+            return 64 - popcount(x);
+#endif
+        }
+
+        // NOTE(Dedrick): Exponential search for the first element not less than key,
+        // starting from hint. Costs O(lg d) comparisons where d is the distance moved.
+        template <typename Iter, typename Key, typename Compare>
+        [[nodiscard]] auto gallop_lower_bound(Iter first, Iter last, Iter hint, Key const &key, Compare comp) -> Iter {
+            if (hint != last && comp(*hint, key)) {
+                // NOTE(Dedrick): The key is right of the hint, gallop towards last.
+                Iter lo = hint + 1;
+                auto const step = std::distance(lo, last);
+                typename std::iterator_traits<Iter>::difference_type bound = 1;
+                while (bound <= step && comp(*(hint + bound), key)) {
+                    lo = hint + bound + 1;
+                    bound *= 2;
+                }
+                Iter const hi = bound <= step ? hint + bound : last;
+                return std::lower_bound(lo, hi, key, comp);
+            }
+
+            // NOTE(Dedrick): The key is at or left of the hint, gallop towards first.
+            Iter hi = hint;
+            auto const step = std::distance(first, hint);
+            typename std::iterator_traits<Iter>::difference_type bound = 1;
+            while (bound <= step && !comp(*(hint - bound), key)) {
+                hi = hint - bound;
+                bound *= 2;
+            }
+            Iter const lo = bound <= step ? hint - bound + 1 : first;
+            return std::lower_bound(lo, hi, key, comp);
+        }
+
+        // NOTE(Dedrick): Bit index of the rank-th set bit in x, rank < popcount(x).
+        [[nodiscard]] inline auto select_in_word(std::uint64_t x, unsigned rank) noexcept -> std::size_t {
+            for (unsigned i = 0; i < rank; ++i) {
+                x &= x - 1;
+            }
+            return static_cast<std::size_t>(count_trailing_zeros(x));
+        }
+    }
+
+    /**
+     * \brief The default membership filter of flat_map, which filters nothing.
+     * 
+     * A filter is consulted before each find and is told about every insert and
+     * erase. When needs_rebuild returns true, the map hands it all of its elements
+     * again. Custom filters implement the same members.
+     */
+    struct no_filter {
+        template <typename Key>
+        [[nodiscard]] constexpr auto may_contain(Key const &) const noexcept -> bool {
+            return true;
+        }
+
+        template <typename Key>
+        constexpr auto insert(Key const &) noexcept -> void { }
+
+        constexpr auto erase(std::size_t) noexcept -> void { }
+
+        [[nodiscard]] constexpr auto needs_rebuild(std::size_t) const noexcept -> bool {
+            return false;
+        }
+
+        template <typename Iter>
+        constexpr auto rebuild(Iter, Iter, std::size_t) noexcept -> void { }
+
+        constexpr auto clear() noexcept -> void { }
+    };
+
+    /**
+     * \brief Whether Hash gives equal hashes to keys that Compare considers
+     * equivalent, which a hashing filter needs to never reject a stored key. Only
+     * std::hash with std::less or std::greater is known to agree. Specialize this
+     * to opt in other pairs, e.g. a case-insensitive hash and comparator.
+     */
+    template <typename Key, typename Hash, typename Compare>
+    struct hash_agrees_with_compare : std::bool_constant<
+        std::is_same_v<Hash, std::hash<Key>> && (
+            std::is_same_v<Compare, std::less<Key>> ||
+            std::is_same_v<Compare, std::less<>> ||
+            std::is_same_v<Compare, std::greater<Key>> ||
+            std::is_same_v<Compare, std::greater<>>)> { };
+
+    template <typename Key, typename Hash, typename Compare>
+    inline constexpr bool hash_agrees_with_compare_v = hash_agrees_with_compare<Key, Hash, Compare>::value;
+
+    /**
+     * \brief A split block Bloom filter for miss-heavy flat_map lookups. Each key
+     * sets one bit in each of the eight words of a single 64 byte block, so a query
+     * touches exactly one cache line.
+     * 
+     * The filter is sized for twice the number of keys at each rebuild, which keeps
+     * inserts amortized O(1). Erased keys cannot be removed from a Bloom filter, so
+     * it is rebuilt once more keys were erased than remain. With the default of 12
+     * bits per key the false positive rate stays under about 1%.
+     * 
+     * Hash must agree with the comparator of the map, see
+     * hash_agrees_with_compare, which flat_map checks at compile-time.
+     * 
+     * \code
+     * dk::flat_map<std::uint64_t, int, std::less<std::uint64_t>,
+     *     std::vector<std::pair<std::uint64_t, int>>,
+     *     dk::blocked_bloom_filter<std::uint64_t>> map;
+     * \endcode
+     */
+    template <
+        typename Key,
+        typename Hash = std::hash<Key>,
+        std::size_t BitsPerKey = 12>
+    class blocked_bloom_filter {
+    public:
+        using hasher = Hash;
+
+    private:
+        struct alignas(64) block {
+            std::uint64_t words[8];
+        };
+
+        std::vector<block> m_blocks;
+        std::size_t m_capacity = 0;
+        std::size_t m_erased = 0;
+
+    public:
+        [[nodiscard]] auto may_contain(Key const &key) const noexcept -> bool {
+            // NOTE(Dedrick): An unbuilt filter cannot rule anything out.
+            if (m_blocks.empty()) {
+                return true;
+            }
+            std::uint64_t const hash = this->hash(key);
+            block const &b = m_blocks[this->block_index(hash)];
+            std::uint64_t missing = 0;
+            for (unsigned i = 0; i < 8; ++i) {
+                missing |= ~b.words[i] & bit_mask(hash, i);
+            }
+            return missing == 0;
+        }
+
+        auto insert(Key const &key) noexcept -> void {
+            if (m_blocks.empty()) {
+                return;
+            }
+            std::uint64_t const hash = this->hash(key);
+            block &b = m_blocks[this->block_index(hash)];
+            for (unsigned i = 0; i < 8; ++i) {
+                b.words[i] |= bit_mask(hash, i);
+            }
+        }
+
+        auto erase(std::size_t count) noexcept -> void {
+            m_erased += count;
+        }
+
+        [[nodiscard]] auto needs_rebuild(std::size_t size) const noexcept -> bool {
+            return size > m_capacity || m_erased > size;
+        }
+
+        template <typename Iter>
+        auto rebuild(Iter first, Iter last, std::size_t size) -> void {
+            m_capacity = size < 32 ? 64 : size * 2;
+            m_erased = 0;
+            std::size_t const block_count = (m_capacity * BitsPerKey + 511) / 512;
+            m_blocks.assign(block_count, block{ });
+            for (; first != last; ++first) {
+                this->insert(first->first);
+            }
+        }
+
+        auto clear() noexcept -> void {
+            m_blocks.clear();
+            m_capacity = 0;
+            m_erased = 0;
+        }
+
+        /**
+         * \brief Gets the number of bytes used by the filter.
+         */
+        [[nodiscard]] auto memory_usage() const noexcept -> std::size_t {
+            return m_blocks.size() * sizeof(block);
+        }
+
+    private:
+        [[nodiscard]] static auto hash(Key const &key) noexcept -> std::uint64_t {
+            // NOTE(Dedrick): std::hash is the identity for integers on common standard
+            // libraries, so finalize it with the splitmix64 mixer.
+            std::uint64_t x = static_cast<std::uint64_t>(Hash()(key));
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        [[nodiscard]] auto block_index(std::uint64_t hash) const noexcept -> std::size_t {
+            std::uint64_t const count = m_blocks.size();
+            if (count <= 0xFFFFFFFFull) {
+                return static_cast<std::size_t>(((hash >> 32) * count) >> 32);
+            }
+            return static_cast<std::size_t>(hash % count);
+        }
+
+        [[nodiscard]] static auto bit_mask(std::uint64_t hash, unsigned word) noexcept -> std::uint64_t {
+            // NOTE(Dedrick): Salts from the Parquet split block Bloom filter.
+            static constexpr std::uint32_t salts[8] = {
+                0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du,
+                0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u
+            };
+            std::uint32_t const bit = (static_cast<std::uint32_t>(hash) * salts[word]) >> 26;
+            return std::uint64_t{ 1 } << bit;
+        }
+    };
+
+    /**
+     * \brief An order-preserving packing of integer fields into one 64-bit or
+     * 128-bit value, for use as a composite flat_map key. Comparing two packed
+     * keys is one or two integer comparisons without branches, instead of a
+     * field by field lexicographic comparison of a std::tuple.
+     * 
+     * Fields are packed most significant first, signed fields have their sign bit
+     * flipped so that their order is preserved.
+     * 
+     * \code
+     * using key = dk::packed_key<std::uint32_t, std::uint32_t, std::uint64_t>;
+     * dk::flat_map<key, float> map;
+     * map[key(1, 2, 3)] = 1.0f;
+     * std::uint32_t const second = map.begin()->first.get<1>();
+     * \endcode
+     */
+    template <typename... Ts>
+    class packed_key {
+    public:
+        static_assert(sizeof...(Ts) > 0);
+        static_assert((std::is_integral_v<Ts> && ...)); // Only integer fields can be packed.
+
+        static constexpr std::size_t bits = ((sizeof(Ts) * 8) + ...);
+        static_assert(bits <= 128); // Must fit in 128 bits.
+
+    private:
+        // NOTE(Dedrick): m_hi stays 0 for keys of up to 64 bits.
+        std::uint64_t m_hi = 0;
+        std::uint64_t m_lo = 0;
+
+        template <typename U>
+        static constexpr std::size_t field_bits = sizeof(U) * 8;
+
+    public:
+        constexpr packed_key() noexcept = default;
+
+        constexpr explicit packed_key(Ts... values) noexcept {
+            (this->push(values), ...);
+        }
+
+        explicit packed_key(std::tuple<Ts...> const &values) noexcept {
+            std::apply([this](Ts... v) { (this->push(v), ...); }, values);
+        }
+
+        /**
+         * \brief Gets the I-th field.
+         */
+        template <std::size_t I>
+        [[nodiscard]] constexpr auto get() const noexcept -> std::tuple_element_t<I, std::tuple<Ts...>> {
+            using field_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+            return decode<field_type>(this->extract(field_offset<I>(), field_bits<field_type>));
+        }
+
+        /**
+         * \brief Reconstructs the original fields.
+         */
+        [[nodiscard]] auto tuple() const noexcept -> std::tuple<Ts...> {
+            return this->tuple_impl(std::index_sequence_for<Ts...>());
+        }
+
+        [[nodiscard]] constexpr auto high() const noexcept -> std::uint64_t {
+            return m_hi;
+        }
+
+        [[nodiscard]] constexpr auto low() const noexcept -> std::uint64_t {
+            return m_lo;
+        }
+
+        [[nodiscard]] friend constexpr auto operator==(packed_key const &lhs, packed_key const &rhs) noexcept -> bool {
+            return ((lhs.m_hi ^ rhs.m_hi) | (lhs.m_lo ^ rhs.m_lo)) == 0;
+        }
+
+        [[nodiscard]] friend constexpr auto operator!=(packed_key const &lhs, packed_key const &rhs) noexcept -> bool {
+            return !(lhs == rhs);
+        }
+
+        [[nodiscard]] friend constexpr auto operator<(packed_key const &lhs, packed_key const &rhs) noexcept -> bool {
+            if constexpr (bits <= 64) {
+                return lhs.m_lo < rhs.m_lo;
+            } else {
+                return (lhs.m_hi < rhs.m_hi) | ((lhs.m_hi == rhs.m_hi) & (lhs.m_lo < rhs.m_lo));
+            }
+        }
+
+        [[nodiscard]] friend constexpr auto operator>(packed_key const &lhs, packed_key const &rhs) noexcept -> bool {
+            return rhs < lhs;
+        }
+
+        [[nodiscard]] friend constexpr auto operator<=(packed_key const &lhs, packed_key const &rhs) noexcept -> bool {
+            return !(rhs < lhs);
+        }
+
+        [[nodiscard]] friend constexpr auto operator>=(packed_key const &lhs, packed_key const &rhs) noexcept -> bool {
+            return !(lhs < rhs);
+        }
+
+    private:
+        template <typename U>
+        [[nodiscard]] static constexpr auto encode(U value) noexcept -> std::uint64_t {
+            using unsigned_type = std::make_unsigned_t<U>;
+            auto bits_value = static_cast<std::uint64_t>(static_cast<unsigned_type>(value));
+            if constexpr (std::is_signed_v<U>) {
+                bits_value ^= std::uint64_t{ 1 } << (field_bits<U> - 1);
+            }
+            return bits_value;
+        }
+
+        template <typename U>
+        [[nodiscard]] static constexpr auto decode(std::uint64_t bits_value) noexcept -> U {
+            if constexpr (std::is_signed_v<U>) {
+                bits_value ^= std::uint64_t{ 1 } << (field_bits<U> - 1);
+            }
+            return static_cast<U>(static_cast<std::make_unsigned_t<U>>(bits_value));
+        }
+
+        template <typename U>
+        constexpr auto push(U value) noexcept -> void {
+            constexpr std::size_t width = field_bits<U>;
+            if constexpr (width == 64) {
+                m_hi = m_lo;
+                m_lo = 0;
+            } else {
+                m_hi = (m_hi << width) | (m_lo >> (64 - width));
+                m_lo <<= width;
+            }
+            m_lo |= encode(value);
+        }
+
+        // NOTE(Dedrick): Offset of the I-th field from the least significant bit.
+        template <std::size_t I>
+        [[nodiscard]] static constexpr auto field_offset() noexcept -> std::size_t {
+            constexpr std::size_t widths[] = { field_bits<Ts>... };
+            std::size_t offset = 0;
+            for (std::size_t i = I + 1; i < sizeof...(Ts); ++i) {
+                offset += widths[i];
+            }
+            return offset;
+        }
+
+        [[nodiscard]] constexpr auto extract(std::size_t offset, std::size_t width) const noexcept -> std::uint64_t {
+            std::uint64_t value = 0;
+            if (offset >= 64) {
+                value = m_hi >> (offset - 64);
+            } else if (offset == 0) {
+                value = m_lo;
+            } else {
+                value = (m_lo >> offset) | (m_hi << (64 - offset));
+            }
+            return width == 64 ? value : value & ((std::uint64_t{ 1 } << width) - 1);
+        }
+
+        template <std::size_t... Is>
+        [[nodiscard]] auto tuple_impl(std::index_sequence<Is...>) const noexcept -> std::tuple<Ts...> {
+            return std::tuple<Ts...>(this->get<Is>()...);
+        }
+    };
+
+    /**
+     * \brief The default growth policy of flat_map, which leaves growth to the
+     * container, usually doubling its capacity.
+     * 
+     * A growth policy returns the capacity to reserve when an insert finds the
+     * container full, or 0 to let the container decide.
+     */
+    struct container_growth {
+        [[nodiscard]] constexpr auto next_capacity(std::size_t, std::size_t) const noexcept -> std::size_t {
+            return 0;
+        }
+    };
+
+    /**
+     * \brief Grows the capacity by Num / Den when full. ratio_growth<5, 4> wastes at
+     * most 25% of the array, at the cost of reallocating more often than doubling.
+     */
+    template <std::size_t Num, std::size_t Den>
+    struct ratio_growth {
+        static_assert(Num > Den && Den > 0); // Must grow.
+
+        [[nodiscard]] constexpr auto next_capacity(std::size_t capacity, std::size_t required) const noexcept -> std::size_t {
+            std::size_t const grown = capacity / Den * Num + capacity % Den * Num / Den;
+            return grown > required ? grown : required;
+        }
+    };
+
     template <
         typename Key, typename T,
         typename Compare = std::less<Key>,
-        typename Container = std::vector<std::pair<Key, T>>>
-    class flat_map {
+        typename Container = std::vector<std::pair<Key, T>>,
+        typename Filter = no_filter,
+        typename Growth = container_growth>
+    class flat_map : private Filter, private Growth {
     public:
         using key_type = Key;
         using mapped_type = T;
         using value_type = std::pair<key_type, mapped_type>;
         using key_compare = Compare;
         using container = Container;
+        using filter_type = Filter;
+        using growth_type = Growth;
         using size_type = typename container::size_type;
         using iterator = typename container::iterator;
         using const_iterator = typename container::const_iterator;
         using reverse_iterator = typename container::reverse_iterator;
         using const_reverse_iterator = typename container::const_reverse_iterator;
 
+        static_assert(
+            std::is_void_v<typename detail::filter_hasher<Filter>::type> ||
+            hash_agrees_with_compare_v<Key, typename detail::filter_hasher<Filter>::type, Compare>); // Filter hash must agree with Compare.
+
     private:
+        // NOTE(Dedrick): Filter and Growth are private bases so that empty policies take no space.
+
+        // NOTE(Dedrick): Shift elements with memmove instead of element-wise moves.
+        static constexpr bool relocate_with_memmove =
+            is_trivially_relocatable_v<value_type> &&
+            detail::is_contiguous_container<container>::value;
+
         container m_container;
 
     public:
         flat_map() = default;
 
         explicit flat_map(std::initializer_list<value_type> list) : flat_map() {
-            m_container.reserve(list.size());
+            this->reserve(static_cast<size_type>(list.size()));
             for (auto it = std::begin(list); it != std::end(list); ++it) {
                 m_container.emplace_back(*it);
             }
             this->sort();
             this->remove_duplicates();
+            this->rebuild_filter();
         }
 
         template <typename Iter>
         flat_map(Iter begin, Iter end) : flat_map() {
-            m_container.reserve(std::distance(begin, end));
+            this->reserve(static_cast<size_type>(std::distance(begin, end)));
             for (; begin != end; ++begin) {
                 m_container.emplace_back(*begin);
             }
             this->sort();
             this->remove_duplicates();
+            this->rebuild_filter();
         }
 
         flat_map(flat_map const &) = default;
@@ -77,6 +841,18 @@ namespace dk {
 
         ~flat_map() = default;
 
+        // NOTE(Dedrick): Deduced so that containers without an allocator still compile.
+        [[nodiscard]] auto get_allocator() const -> decltype(auto) {
+            return m_container.get_allocator();
+        }
+
+        /**
+         * \brief Gets the membership filter, e.g. for its memory_usage().
+         */
+        [[nodiscard]] auto get_filter() const noexcept -> filter_type const& {
+            return *this;
+        }
+
         [[nodiscard]] auto begin() noexcept -> iterator {
             return m_container.begin();
         }
@@ -137,6 +913,37 @@ namespace dk {
             return m_container.max_size();
         }
 
+        /**
+         * \brief Gets the number of elements the map can hold without reallocating.
+         * Containers without a capacity report their size.
+         */
+        [[nodiscard]] auto capacity() const noexcept -> size_type {
+            if constexpr (detail::has_capacity<container>::value) {
+                return m_container.capacity();
+            } else {
+                return m_container.size();
+            }
+        }
+
+        /**
+         * \brief Reserves room for count elements. Does nothing for containers that
+         * cannot reserve, such as fixed capacity ones.
+         */
+        auto reserve(size_type count) -> void {
+            if constexpr (detail::has_reserve<container>::value) {
+                m_container.reserve(count);
+            }
+        }
+
+        /**
+         * \brief Releases unused capacity. Does nothing for containers that cannot.
+         */
+        auto shrink_to_fit() -> void {
+            if constexpr (detail::has_shrink_to_fit<container>::value) {
+                m_container.shrink_to_fit();
+            }
+        }
+
         auto operator[](key_type const &key) -> mapped_type& {
             return this->try_emplace(key).first->second;
         }
@@ -149,11 +956,12 @@ namespace dk {
         auto try_emplace(key_type const &key, Args &&...args) -> std::pair<iterator, bool> {
             auto it = this->lower_bound(key);
             if (it == std::end(m_container) || !equal_op()(*it, key)) {
-                it = m_container.emplace(
-                    this->upper_bound(key),
+                it = this->emplace_at(
+                    it,
                     std::piecewise_construct,
                     std::forward_as_tuple(key),
                     std::forward_as_tuple(std::forward<Args>(args)...));
+                this->filter_insert(it->first);
                 return std::make_pair(it, true);
             }
             return std::make_pair(it, false);
@@ -163,60 +971,99 @@ namespace dk {
         auto try_emplace(key_type &&key, Args &&...args) -> std::pair<iterator, bool> {
             auto it = this->lower_bound(key);
             if (it == std::end(m_container) || !equal_op()(*it, key)) {
-                it = m_container.emplace(
-                    this->upper_bound(key),
+                it = this->emplace_at(
+                    it,
                     std::piecewise_construct,
                     std::forward_as_tuple(std::move(key)),
                     std::forward_as_tuple(std::forward<Args>(args)...));
+                this->filter_insert(it->first);
                 return std::make_pair(it, true);
             }
             return std::make_pair(it, false);
         }
 
+        /**
+         * \brief Inserts if the key is absent. The key is extracted or constructed
+         * first, so on a duplicate key the mapped value is never constructed.
+         */
         template <typename... Args>
         auto emplace(Args &&...args) -> std::pair<iterator, bool> {
-            value_type value(std::forward<Args>(args)...);
-            return this->try_emplace(std::move(value.first), std::move(value.second));
+            return this->emplace_key_first(std::forward<Args>(args)...);
         }
 
         auto insert(value_type const &value) -> std::pair<iterator, bool> {
-            return this->emplace(value);
+            return this->try_emplace(value.first, value.second);
         }
 
         auto insert(value_type &&value) -> std::pair<iterator, bool> {
-            return this->emplace(std::move(value));
+            return this->try_emplace(std::move(value.first), std::move(value.second));
         }
 
         auto erase(iterator pos) -> iterator {
-            return m_container.erase(pos);
+            auto const it = this->erase_at(pos);
+            this->filter_erase(1);
+            return it;
         }
 
         auto erase(const_iterator pos) -> iterator {
-            return m_container.erase(pos);
+            auto const it = this->erase_at(pos);
+            this->filter_erase(1);
+            return it;
         }
 
         auto erase(const_iterator begin, const_iterator end) -> iterator {
-            return m_container.erase(begin, end);
+            auto const count = static_cast<std::size_t>(std::distance(begin, end));
+            auto const it = m_container.erase(begin, end);
+            this->filter_erase(count);
+            return it;
         }
 
         auto erase(key_type const &key) -> size_type {
+            if (!this->filter().may_contain(key)) {
+                return 0;
+            }
             auto const it = this->lower_bound(key);
             if (it != std::end(m_container) && equal_op()(*it, key)) {
-                m_container.erase(it);
+                this->erase_at(it);
+                this->filter_erase(1);
                 return 1;
             }
             return 0;
         }
 
         auto swap(flat_map &other) noexcept -> void {
+            using std::swap;
             m_container.swap(other.m_container);
+            swap(this->filter(), other.filter());
         }
 
         auto clear() noexcept -> void {
             m_container.clear();
+            this->filter().clear();
+        }
+
+        /**
+         * \brief Replaces the elements with those of c, which must be sorted by key
+         * and free of duplicates. Use with extract() for bulk rewrites.
+         */
+        auto replace(container &&c) -> void {
+            m_container = std::move(c);
+            this->rebuild_filter();
+        }
+
+        /**
+         * \brief Moves the backing container out, leaving the map empty.
+         */
+        [[nodiscard]] auto extract() && -> container {
+            container c = std::move(m_container);
+            this->clear();
+            return c;
         }
 
         auto find(key_type const &key) noexcept -> iterator {
+            if (!this->filter().may_contain(key)) {
+                return std::end(m_container);
+            }
             auto const it = this->lower_bound(key);
             if (it != std::end(m_container) && equal_op()(*it, key)) {
                 return it;
@@ -225,6 +1072,9 @@ namespace dk {
         }
 
         auto find(key_type const &key) const noexcept -> const_iterator {
+            if (!this->filter().may_contain(key)) {
+                return std::end(m_container);
+            }
             auto const it = this->lower_bound(key);
             if (it != std::end(m_container) && equal_op()(*it, key)) {
                 return it;
@@ -268,48 +1118,1895 @@ namespace dk {
             return std::make_pair(lower_it, upper_it);
         }
 
-    private:
-        struct compare_op {
-            auto operator()(value_type const &a, value_type const &b) const noexcept -> bool {
-                return key_compare()(a.first, b.first);
-            }
+        /**
+         * \brief Gets the number of elements with a key less than key, which is also
+         * the index key would be inserted at. O(lg n).
+         */
+        [[nodiscard]] auto rank(key_type const &key) const -> size_type {
+            return static_cast<size_type>(std::distance(std::begin(m_container), this->lower_bound(key)));
+        }
 
-            auto operator()(value_type const &value, key_type const &key) const noexcept -> bool {
-                return key_compare()(value.first, key);
+        /**
+         * \brief Computes rank() for every key in [first, last) into out. Each search
+         * gallops from the previous result, so sorted or clustered keys cost
+         * O(lg d) each, where d is the distance between consecutive ranks.
+         */
+        template <typename InputIter, typename OutputIter>
+        auto rank_batch(InputIter first, InputIter last, OutputIter out) const -> OutputIter {
+            auto const begin = std::begin(m_container);
+            auto const end = std::end(m_container);
+            auto hint = begin;
+            for (; first != last; ++first, ++out) {
+                hint = detail::gallop_lower_bound(begin, end, hint, *first, compare_op());
+                *out = static_cast<size_type>(std::distance(begin, hint));
             }
+            return out;
+        }
 
-            auto operator()(key_type const &key, value_type const &value) const noexcept -> bool {
-                return key_compare()(key, value.first);
-            }
-        };
+        /**
+         * \brief Gets the element with the given rank in O(1).
+         */
+        [[nodiscard]] auto nth(size_type idx) noexcept -> iterator {
+            return std::begin(m_container) + static_cast<std::ptrdiff_t>(idx);
+        }
 
-        struct equal_op {
-            auto operator()(value_type const &a, value_type const &b) const noexcept -> bool {
-                return !compare_op()(a, b) && !compare_op()(b, a);
-            }
+        [[nodiscard]] auto nth(size_type idx) const noexcept -> const_iterator {
+            return std::begin(m_container) + static_cast<std::ptrdiff_t>(idx);
+        }
 
-            auto operator()(value_type const &a, key_type const &b) const noexcept -> bool {
-                return !compare_op()(a, b) && !compare_op()(b, a);
-            }
+        /**
+         * \brief Gets the rank of the element at pos in O(1).
+         */
+        [[nodiscard]] auto index_of(const_iterator pos) const noexcept -> size_type {
+            return static_cast<size_type>(std::distance(std::cbegin(m_container), pos));
+        }
 
-            auto operator()(key_type const &a, value_type const &b) const noexcept -> bool {
-                return !compare_op()(a, b) && !compare_op()(b, a);
+        /**
+         * \brief Gets the element at quantile q in [0, 1] using the nearest rank
+         * below, e.g. quantile(0.5) is the lower median. Returns end() if empty.
+         */
+        [[nodiscard]] auto quantile(double q) const noexcept -> const_iterator {
+            if (m_container.empty()) {
+                return std::end(m_container);
             }
-        };
+            // NOTE(Dedrick): Written so NaN compares false and clamps to 0, since converting
+            // NaN to an integer is undefined.
+            q = !(q >= 0.0) ? 0.0 : (q > 1.0 ? 1.0 : q);
+            auto const idx = static_cast<size_type>(q * static_cast<double>(m_container.size() - 1));
+            return this->nth(idx);
+        }
 
-        auto sort() -> void {
-            std::sort(std::begin(m_container), std::end(m_container), compare_op());
+        /**
+         * \brief Gets the number of elements with a key in [lo, hi).
+         */
+        [[nodiscard]] auto count_range(key_type const &lo, key_type const &hi) const -> size_type {
+            auto const lower_it = this->lower_bound(lo);
+            if (lower_it == std::end(m_container) || !key_compare()(lo, hi)) {
+                return 0;
+            }
+            auto const upper_it = std::lower_bound(lower_it, std::end(m_container), hi, compare_op());
+            return static_cast<size_type>(std::distance(lower_it, upper_it));
         }
 
-        auto remove_duplicates() -> void {
+        /**
+         * \brief A random access iterator that holds a rank instead of a position,
+         * so index() is O(1) and it stays valid when the map reallocates. Inserting
+         * or erasing before it changes which element it refers to.
+         * 
+         * \code
+         * for (auto it = map.index_begin(); it != map.index_end(); ++it) {
+         *     percentiles[it.index() * 100 / map.size()] += it->second;
+         * }
+         * \endcode
+         */
+        template <bool Const>
+        class basic_index_iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = typename flat_map::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const, typename container::const_reference, typename container::reference>;
+            using pointer = std::conditional_t<Const, typename container::const_pointer, typename container::pointer>;
+
+        private:
+            friend class flat_map;
+
+            template <bool>
+            friend class basic_index_iterator;
+
+            using map_pointer = std::conditional_t<Const, flat_map const *, flat_map *>;
+
+            map_pointer m_map = nullptr;
+            size_type m_index = 0;
+
+            basic_index_iterator(map_pointer map, size_type index) noexcept :
+                m_map{ map },
+                m_index{ index } { }
+
+        public:
+            basic_index_iterator() = default;
+
+            template <bool RhsConst, typename = std::enable_if_t<Const && !RhsConst>>
+            basic_index_iterator(basic_index_iterator<RhsConst> const &rhs) noexcept :
+                m_map{ rhs.m_map },
+                m_index{ rhs.m_index } { }
+
+            [[nodiscard]] auto index() const noexcept -> size_type {
+                return m_index;
+            }
+
+            [[nodiscard]] auto operator*() const noexcept -> reference {
+                return *m_map->nth(m_index);
+            }
+
+            [[nodiscard]] auto operator->() const noexcept -> pointer {
+                return &**this;
+            }
+
+            [[nodiscard]] auto operator[](difference_type n) const noexcept -> reference {
+                return *(*this + n);
+            }
+
+            auto operator++() noexcept -> basic_index_iterator& {
+                ++m_index;
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> basic_index_iterator {
+                basic_index_iterator tmp = *this;
+                ++m_index;
+                return tmp;
+            }
+
+            auto operator--() noexcept -> basic_index_iterator& {
+                --m_index;
+                return *this;
+            }
+
+            auto operator--(int) noexcept -> basic_index_iterator {
+                basic_index_iterator tmp = *this;
+                --m_index;
+                return tmp;
+            }
+
+            auto operator+=(difference_type n) noexcept -> basic_index_iterator& {
+                m_index = static_cast<size_type>(static_cast<difference_type>(m_index) + n);
+                return *this;
+            }
+
+            auto operator-=(difference_type n) noexcept -> basic_index_iterator& {
+                return *this += -n;
+            }
+
+            [[nodiscard]] friend auto operator+(basic_index_iterator it, difference_type n) noexcept -> basic_index_iterator {
+                return it += n;
+            }
+
+            [[nodiscard]] friend auto operator+(difference_type n, basic_index_iterator it) noexcept -> basic_index_iterator {
+                return it += n;
+            }
+
+            [[nodiscard]] friend auto operator-(basic_index_iterator it, difference_type n) noexcept -> basic_index_iterator {
+                return it -= n;
+            }
+
+            [[nodiscard]] friend auto operator-(basic_index_iterator const &lhs, basic_index_iterator const &rhs) noexcept -> difference_type {
+                return static_cast<difference_type>(lhs.m_index) - static_cast<difference_type>(rhs.m_index);
+            }
+
+            [[nodiscard]] friend auto operator==(basic_index_iterator const &lhs, basic_index_iterator const &rhs) noexcept -> bool {
+                return lhs.m_index == rhs.m_index;
+            }
+
+            [[nodiscard]] friend auto operator!=(basic_index_iterator const &lhs, basic_index_iterator const &rhs) noexcept -> bool {
+                return lhs.m_index != rhs.m_index;
+            }
+
+            [[nodiscard]] friend auto operator<(basic_index_iterator const &lhs, basic_index_iterator const &rhs) noexcept -> bool {
+                return lhs.m_index < rhs.m_index;
+            }
+
+            [[nodiscard]] friend auto operator>(basic_index_iterator const &lhs, basic_index_iterator const &rhs) noexcept -> bool {
+                return rhs.m_index < lhs.m_index;
+            }
+
+            [[nodiscard]] friend auto operator<=(basic_index_iterator const &lhs, basic_index_iterator const &rhs) noexcept -> bool {
+                return !(rhs.m_index < lhs.m_index);
+            }
+
+            [[nodiscard]] friend auto operator>=(basic_index_iterator const &lhs, basic_index_iterator const &rhs) noexcept -> bool {
+                return !(lhs.m_index < rhs.m_index);
+            }
+        };
+
+        using index_iterator = basic_index_iterator<false>;
+        using const_index_iterator = basic_index_iterator<true>;
+
+        [[nodiscard]] auto index_begin() noexcept -> index_iterator {
+            return index_iterator{ this, 0 };
+        }
+
+        [[nodiscard]] auto index_end() noexcept -> index_iterator {
+            return index_iterator{ this, static_cast<size_type>(m_container.size()) };
+        }
+
+        [[nodiscard]] auto index_begin() const noexcept -> const_index_iterator {
+            return const_index_iterator{ this, 0 };
+        }
+
+        [[nodiscard]] auto index_end() const noexcept -> const_index_iterator {
+            return const_index_iterator{ this, static_cast<size_type>(m_container.size()) };
+        }
+
+        /**
+         * \brief Gets the index iterator at the given rank, e.g. nth_index(rank(key)).
+         */
+        [[nodiscard]] auto nth_index(size_type idx) noexcept -> index_iterator {
+            return index_iterator{ this, idx };
+        }
+
+        [[nodiscard]] auto nth_index(size_type idx) const noexcept -> const_index_iterator {
+            return const_index_iterator{ this, idx };
+        }
+
+        /**
+         * \brief Remembers the position of the last lookup and gallops from it, so
+         * a sequence of nearby lookups costs O(lg d) each, where d is the distance
+         * moved, instead of O(lg n).
+         * 
+         * The cursor stores an index, so it stays usable after the map reallocates,
+         * it only loses locality if the map is modified through other means.
+         * 
+         * \code
+         * dk::flat_map<int, int>::cursor cursor(map);
+         * for (int key : sorted_keys) {
+         *     auto const it = cursor.find(key);
+         * }
+         * \endcode
+         */
+        class cursor {
+        private:
+            flat_map *m_map;
+            size_type m_index;
+
+        public:
+            explicit cursor(flat_map &map) noexcept :
+                m_map{ &map },
+                m_index{ 0 } { }
+
+            [[nodiscard]] auto position() const noexcept -> size_type {
+                return m_index;
+            }
+
+            [[nodiscard]] auto lower_bound(key_type const &key) -> iterator {
+                container &c = m_map->m_container;
+                auto const first = std::begin(c);
+                auto const last = std::end(c);
+                auto const hint = first + (m_index < c.size() ? m_index : c.size());
+                auto const it = detail::gallop_lower_bound(first, last, hint, key, compare_op());
+                m_index = static_cast<size_type>(std::distance(first, it));
+                return it;
+            }
+
+            [[nodiscard]] auto find(key_type const &key) -> iterator {
+                if (!m_map->filter().may_contain(key)) {
+                    return m_map->end();
+                }
+                auto const it = this->lower_bound(key);
+                if (it != m_map->end() && equal_op()(*it, key)) {
+                    return it;
+                }
+                return m_map->end();
+            }
+
+            [[nodiscard]] auto contains(key_type const &key) -> bool {
+                return this->find(key) != m_map->end();
+            }
+
+            template <typename... Args>
+            auto try_emplace(key_type const &key, Args &&...args) -> std::pair<iterator, bool> {
+                auto it = this->lower_bound(key);
+                if (it == m_map->end() || !equal_op()(*it, key)) {
+                    it = m_map->emplace_at(
+                        it,
+                        std::piecewise_construct,
+                        std::forward_as_tuple(key),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+                    m_map->filter_insert(it->first);
+                    return std::make_pair(it, true);
+                }
+                return std::make_pair(it, false);
+            }
+
+            template <typename... Args>
+            auto try_emplace(key_type &&key, Args &&...args) -> std::pair<iterator, bool> {
+                auto it = this->lower_bound(key);
+                if (it == m_map->end() || !equal_op()(*it, key)) {
+                    it = m_map->emplace_at(
+                        it,
+                        std::piecewise_construct,
+                        std::forward_as_tuple(std::move(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+                    m_map->filter_insert(it->first);
+                    return std::make_pair(it, true);
+                }
+                return std::make_pair(it, false);
+            }
+        };
+
+    private:
+        struct compare_op {
+            auto operator()(value_type const &a, value_type const &b) const noexcept -> bool {
+                return key_compare()(a.first, b.first);
+            }
+
+            auto operator()(value_type const &value, key_type const &key) const noexcept -> bool {
+                return key_compare()(value.first, key);
+            }
+
+            auto operator()(key_type const &key, value_type const &value) const noexcept -> bool {
+                return key_compare()(key, value.first);
+            }
+        };
+
+        struct equal_op {
+            auto operator()(value_type const &a, value_type const &b) const noexcept -> bool {
+                return !compare_op()(a, b) && !compare_op()(b, a);
+            }
+
+            auto operator()(value_type const &a, key_type const &b) const noexcept -> bool {
+                return !compare_op()(a, b) && !compare_op()(b, a);
+            }
+
+            auto operator()(key_type const &a, value_type const &b) const noexcept -> bool {
+                return !compare_op()(a, b) && !compare_op()(b, a);
+            }
+        };
+
+        template <typename K, typename M>
+        auto emplace_key_first(K &&key, M &&mapped) -> std::pair<iterator, bool> {
+            if constexpr (std::is_same_v<std::remove_cv_t<std::remove_reference_t<K>>, key_type>) {
+                return this->try_emplace(std::forward<K>(key), std::forward<M>(mapped));
+            } else {
+                return this->try_emplace(key_type(std::forward<K>(key)), std::forward<M>(mapped));
+            }
+        }
+
+        template <typename P, typename = std::enable_if_t<detail::is_pair_v<std::remove_cv_t<std::remove_reference_t<P>>>>>
+        auto emplace_key_first(P &&pair) -> std::pair<iterator, bool> {
+            return this->emplace_key_first(std::get<0>(std::forward<P>(pair)), std::get<1>(std::forward<P>(pair)));
+        }
+
+        template <typename... KeyArgs, typename... MappedArgs>
+        auto emplace_key_first(
+            std::piecewise_construct_t,
+            std::tuple<KeyArgs...> key_args,
+            std::tuple<MappedArgs...> mapped_args) -> std::pair<iterator, bool> {
+            key_type key = std::make_from_tuple<key_type>(std::move(key_args));
+            return std::apply([&](auto &&...args) {
+                return this->try_emplace(std::move(key), std::forward<decltype(args)>(args)...);
+            }, std::move(mapped_args));
+        }
+
+        // NOTE(Dedrick): Anything else only value_type knows how to split.
+        template <typename... Args>
+        auto emplace_key_first(Args &&...args) -> std::pair<iterator, bool> {
+            value_type value(std::forward<Args>(args)...);
+            return this->try_emplace(std::move(value.first), std::move(value.second));
+        }
+
+        template <typename... Args>
+        auto emplace_at(const_iterator pos, Args &&...args) -> iterator {
+            if constexpr (detail::has_reserve<container>::value && detail::has_capacity<container>::value) {
+                if (m_container.size() == m_container.capacity()) {
+                    auto const index = std::distance(cbegin(), pos);
+                    std::size_t const next = static_cast<growth_type const &>(*this).next_capacity(
+                        static_cast<std::size_t>(m_container.capacity()),
+                        static_cast<std::size_t>(m_container.size()) + 1);
+                    if (next != 0) {
+                        // NOTE(Dedrick): Build the value before growing since args may alias
+                        // an element that reserve is about to free.
+                        value_type value(std::forward<Args>(args)...);
+                        m_container.reserve(static_cast<size_type>(next));
+                        return this->emplace_at(std::begin(m_container) + index, std::move(value));
+                    }
+                }
+            }
+            if constexpr (relocate_with_memmove) {
+                // NOTE(Dedrick): A reallocating emplace already copies everything once, so
+                // only take the memmove path when the new element fits in place.
+                if (m_container.size() < m_container.capacity()) {
+                    auto const index = std::distance(cbegin(), pos);
+                    m_container.emplace_back(std::forward<Args>(args)...);
+
+                    // NOTE(Dedrick): Relocate the new last element into the insertion point
+                    // by stashing its bytes, shifting the tail right once and writing it back.
+                    value_type *const base = m_container.data();
+                    value_type *const p_insert = base + index;
+                    value_type *const p_last = base + (m_container.size() - 1);
+                    if (p_insert != p_last) {
+                        alignas(value_type) unsigned char tmp[sizeof(value_type)];
+                        std::memcpy(tmp, static_cast<void *>(p_last), sizeof(value_type));
+                        std::memmove(
+                            static_cast<void *>(p_insert + 1),
+                            static_cast<void *>(p_insert),
+                            static_cast<std::size_t>(p_last - p_insert) * sizeof(value_type));
+                        std::memcpy(static_cast<void *>(p_insert), tmp, sizeof(value_type));
+                    }
+                    return std::begin(m_container) + index;
+                }
+            }
+            return m_container.emplace(pos, std::forward<Args>(args)...);
+        }
+
+        auto erase_at(const_iterator pos) -> iterator {
+            if constexpr (relocate_with_memmove) {
+                auto const index = std::distance(cbegin(), pos);
+
+                // NOTE(Dedrick): Relocate the erased element to the back by stashing its bytes,
+                // shifting the tail left once and writing it back, then let pop_back destroy it.
+                value_type *const base = m_container.data();
+                value_type *const p_erase = base + index;
+                value_type *const p_last = base + (m_container.size() - 1);
+                if (p_erase != p_last) {
+                    alignas(value_type) unsigned char tmp[sizeof(value_type)];
+                    std::memcpy(tmp, static_cast<void *>(p_erase), sizeof(value_type));
+                    std::memmove(
+                        static_cast<void *>(p_erase),
+                        static_cast<void *>(p_erase + 1),
+                        static_cast<std::size_t>(p_last - p_erase) * sizeof(value_type));
+                    std::memcpy(static_cast<void *>(p_last), tmp, sizeof(value_type));
+                }
+                m_container.pop_back();
+                return std::begin(m_container) + index;
+            } else {
+                return m_container.erase(pos);
+            }
+        }
+
+        [[nodiscard]] auto filter() noexcept -> filter_type& {
+            return *this;
+        }
+
+        [[nodiscard]] auto filter() const noexcept -> filter_type const& {
+            return *this;
+        }
+
+        auto filter_insert(key_type const &key) -> void {
+            this->filter().insert(key);
+            if (this->filter().needs_rebuild(static_cast<std::size_t>(m_container.size()))) {
+                this->rebuild_filter();
+            }
+        }
+
+        auto filter_erase(std::size_t count) -> void {
+            this->filter().erase(count);
+            if (this->filter().needs_rebuild(static_cast<std::size_t>(m_container.size()))) {
+                this->rebuild_filter();
+            }
+        }
+
+        auto rebuild_filter() -> void {
+            this->filter().rebuild(
+                std::begin(m_container), std::end(m_container),
+                static_cast<std::size_t>(m_container.size()));
+        }
+
+        auto sort() -> void {
+            std::sort(std::begin(m_container), std::end(m_container), compare_op());
+        }
+
+        auto remove_duplicates() -> void {
             auto end = std::unique(std::begin(m_container), std::end(m_container), equal_op());
             m_container.erase(end, std::end(m_container));
         }
     };
+
+    /**
+     * \brief A read-only map from sorted 64-bit integer keys to values. Keys are
+     * stored with Elias-Fano encoding in roughly 2 + log2(U / n) bits each, where
+     * U is the largest key and n the number of keys. Values are kept uncompressed
+     * in a parallel array.
+     * 
+     * Lookups cost two sampled select operations plus a binary search within a
+     * bucket of keys sharing the same high bits. Iteration decodes keys in order.
+     * 
+     * \code
+     * dk::flat_map<std::uint64_t, float> map = ...;
+     * dk::elias_fano_map<float> const frozen(map);
+     * auto const it = frozen.find(42);
+     * \endcode
+     */
+    template <typename T>
+    class elias_fano_map {
+    public:
+        using key_type = std::uint64_t;
+        using mapped_type = T;
+        using size_type = std::size_t;
+
+        class const_iterator;
+
+    private:
+        // NOTE(Dedrick): Position of every sample_rate-th one/zero in the high bits.
+        // Each select skips to the nearest sample, then scans at most a few words.
+        static constexpr size_type sample_rate = 256;
+
+        std::vector<std::uint64_t> m_low;
+        std::vector<std::uint64_t> m_high;
+        std::vector<std::uint64_t> m_select1;
+        std::vector<std::uint64_t> m_select0;
+        std::vector<mapped_type> m_values;
+        key_type m_max_key = 0;
+        unsigned m_low_bits = 0;
+
+    public:
+        elias_fano_map() = default;
+
+        /**
+         * \brief Builds the map from a range of key/value pairs. Keys must be
+         * strictly ascending, as they are when iterating a dk::flat_map.
+         * \throws std::invalid_argument if the keys are not strictly ascending.
+         */
+        template <typename Iter>
+        elias_fano_map(Iter first, Iter last) {
+            static_assert(std::is_base_of_v<
+                std::forward_iterator_tag,
+                typename std::iterator_traits<Iter>::iterator_category>); // Range is read twice.
+
+            // NOTE(Dedrick): First pass validates the order and finds the universe.
+            size_type count = 0;
+            for (Iter it = first; it != last; ++it, ++count) {
+                key_type const key = it->first;
+                if (count != 0 && key <= m_max_key) {
+                    throw std::invalid_argument("elias_fano_map: keys must be strictly ascending");
+                }
+                m_max_key = key;
+            }
+            if (count == 0) {
+                return;
+            }
+
+            key_type const ratio = m_max_key / count;
+            m_low_bits = ratio == 0 ? 0 : static_cast<unsigned>(63 - detail::count_leading_zeros(ratio));
+
+            size_type const high_bits = count + static_cast<size_type>(m_max_key >> m_low_bits) + 1;
+            m_high.assign((high_bits + 63) / 64, 0);
+            m_low.assign((count * m_low_bits + 63) / 64, 0);
+            m_values.reserve(count);
+
+            // NOTE(Dedrick): Second pass writes the low bits verbatim and the high bits in
+            // unary, where the i-th key sets bit (key >> low_bits) + i.
+            size_type i = 0;
+            for (Iter it = first; it != last; ++it, ++i) {
+                key_type const key = it->first;
+                set_low(i, key);
+                size_type const pos = static_cast<size_type>(key >> m_low_bits) + i;
+                m_high[pos / 64] |= std::uint64_t{ 1 } << (pos % 64);
+                m_values.emplace_back(it->second);
+            }
+
+            build_select_samples(high_bits);
+        }
+
+        template <typename Compare, typename Container, typename Filter, typename Growth>
+        explicit elias_fano_map(flat_map<key_type, mapped_type, Compare, Container, Filter, Growth> const &map) :
+            elias_fano_map(std::begin(map), std::end(map)) { }
+
+        [[nodiscard]] auto begin() const noexcept -> const_iterator {
+            return this->iterator_at(0);
+        }
+
+        [[nodiscard]] auto end() const noexcept -> const_iterator {
+            return const_iterator{ this, size(), 0 };
+        }
+
+        [[nodiscard]] auto cbegin() const noexcept -> const_iterator {
+            return begin();
+        }
+
+        [[nodiscard]] auto cend() const noexcept -> const_iterator {
+            return end();
+        }
+
+        [[nodiscard]] auto empty() const noexcept -> bool {
+            return m_values.empty();
+        }
+
+        [[nodiscard]] auto size() const noexcept -> size_type {
+            return m_values.size();
+        }
+
+        /**
+         * \brief Gets the number of bytes used to encode the keys, excluding values.
+         */
+        [[nodiscard]] auto key_memory_usage() const noexcept -> size_type {
+            return (m_low.size() + m_high.size() + m_select1.size() + m_select0.size()) * sizeof(std::uint64_t);
+        }
+
+        auto at(key_type key) -> mapped_type& {
+            size_type const idx = this->lower_bound_index(key);
+            if (idx == size() || this->key_at(idx) != key) {
+                throw std::out_of_range("elias_fano_map::at: key not found");
+            }
+            return m_values[idx];
+        }
+
+        auto at(key_type key) const -> mapped_type const& {
+            size_type const idx = this->lower_bound_index(key);
+            if (idx == size() || this->key_at(idx) != key) {
+                throw std::out_of_range("elias_fano_map::at: key not found");
+            }
+            return m_values[idx];
+        }
+
+        [[nodiscard]] auto find(key_type key) const noexcept -> const_iterator {
+            size_type const idx = this->lower_bound_index(key);
+            if (idx == size() || this->key_at(idx) != key) {
+                return end();
+            }
+            return this->iterator_at(idx);
+        }
+
+        [[nodiscard]] auto contains(key_type key) const noexcept -> bool {
+            size_type const idx = this->lower_bound_index(key);
+            return idx != size() && this->key_at(idx) == key;
+        }
+
+        [[nodiscard]] auto lower_bound(key_type key) const noexcept -> const_iterator {
+            return this->iterator_at(this->lower_bound_index(key));
+        }
+
+        [[nodiscard]] auto upper_bound(key_type key) const noexcept -> const_iterator {
+            if (key == static_cast<key_type>(-1)) {
+                return end();
+            }
+            return this->iterator_at(this->lower_bound_index(key + 1));
+        }
+
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::pair<key_type, mapped_type>;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::pair<key_type, mapped_type const &>;
+
+            struct pointer {
+                reference ref;
+
+                auto operator->() const noexcept -> reference const* {
+                    return &ref;
+                }
+            };
+
+        private:
+            friend class elias_fano_map;
+
+            elias_fano_map const *m_map = nullptr;
+            size_type m_index = 0;
+            size_type m_pos = 0;
+
+            const_iterator(elias_fano_map const *map, size_type index, size_type pos) noexcept :
+                m_map{ map },
+                m_index{ index },
+                m_pos{ pos } { }
+
+        public:
+            const_iterator() = default;
+
+            [[nodiscard]] auto key() const noexcept -> key_type {
+                return (static_cast<key_type>(m_pos - m_index) << m_map->m_low_bits) | m_map->get_low(m_index);
+            }
+
+            [[nodiscard]] auto value() const noexcept -> mapped_type const& {
+                return m_map->m_values[m_index];
+            }
+
+            [[nodiscard]] auto index() const noexcept -> size_type {
+                return m_index;
+            }
+
+            auto operator*() const noexcept -> reference {
+                return reference{ key(), value() };
+            }
+
+            auto operator->() const noexcept -> pointer {
+                return pointer{ **this };
+            }
+
+            auto operator++() noexcept -> const_iterator& {
+                if (++m_index < m_map->size()) {
+                    m_pos = m_map->next_one(m_pos + 1);
+                } else {
+                    m_pos = 0;
+                }
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> const_iterator {
+                const_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            [[nodiscard]] friend auto operator==(const_iterator const &lhs, const_iterator const &rhs) noexcept -> bool {
+                return lhs.m_index == rhs.m_index;
+            }
+
+            [[nodiscard]] friend auto operator!=(const_iterator const &lhs, const_iterator const &rhs) noexcept -> bool {
+                return lhs.m_index != rhs.m_index;
+            }
+        };
+
+    private:
+        [[nodiscard]] auto get_low(size_type idx) const noexcept -> key_type {
+            if (m_low_bits == 0) {
+                return 0;
+            }
+            size_type const bit = idx * m_low_bits;
+            size_type const word = bit / 64;
+            unsigned const shift = static_cast<unsigned>(bit % 64);
+            std::uint64_t value = m_low[word] >> shift;
+            if (shift + m_low_bits > 64) {
+                value |= m_low[word + 1] << (64 - shift);
+            }
+            return m_low_bits == 64 ? value : value & ((std::uint64_t{ 1 } << m_low_bits) - 1);
+        }
+
+        auto set_low(size_type idx, key_type key) noexcept -> void {
+            if (m_low_bits == 0) {
+                return;
+            }
+            key_type const low = m_low_bits == 64 ? key : key & ((std::uint64_t{ 1 } << m_low_bits) - 1);
+            size_type const bit = idx * m_low_bits;
+            size_type const word = bit / 64;
+            unsigned const shift = static_cast<unsigned>(bit % 64);
+            m_low[word] |= low << shift;
+            if (shift + m_low_bits > 64) {
+                m_low[word + 1] |= low >> (64 - shift);
+            }
+        }
+
+        [[nodiscard]] auto key_at(size_type idx) const noexcept -> key_type {
+            size_type const pos = this->select1(idx);
+            return (static_cast<key_type>(pos - idx) << m_low_bits) | this->get_low(idx);
+        }
+
+        [[nodiscard]] auto iterator_at(size_type idx) const noexcept -> const_iterator {
+            if (idx >= size()) {
+                return end();
+            }
+            return const_iterator{ this, idx, this->select1(idx) };
+        }
+
+        auto build_select_samples(size_type high_bits) -> void {
+            size_type ones = 0;
+            size_type zeros = 0;
+            for (size_type pos = 0; pos < high_bits; ++pos) {
+                bool const bit = (m_high[pos / 64] >> (pos % 64)) & 1;
+                if (bit) {
+                    if (ones % sample_rate == 0) {
+                        m_select1.push_back(pos);
+                    }
+                    ++ones;
+                } else {
+                    if (zeros % sample_rate == 0) {
+                        m_select0.push_back(pos);
+                    }
+                    ++zeros;
+                }
+            }
+        }
+
+        // NOTE(Dedrick): Position of the rank-th one (or zero when Zeros is set) in the high bits.
+        template <bool Zeros>
+        [[nodiscard]] auto select(std::vector<std::uint64_t> const &samples, size_type rank) const noexcept -> size_type {
+            size_type const sample = rank / sample_rate;
+            size_type const start = static_cast<size_type>(samples[sample]);
+            size_type remaining = rank - sample * sample_rate;
+            size_type word = start / 64;
+            std::uint64_t bits = (Zeros ? ~m_high[word] : m_high[word]) & (~std::uint64_t{ 0 } << (start % 64));
+            for (;;) {
+                auto const count = static_cast<size_type>(detail::popcount(bits));
+                if (remaining < count) {
+                    return word * 64 + detail::select_in_word(bits, static_cast<unsigned>(remaining));
+                }
+                remaining -= count;
+                ++word;
+                bits = Zeros ? ~m_high[word] : m_high[word];
+            }
+        }
+
+        [[nodiscard]] auto select1(size_type rank) const noexcept -> size_type {
+            return this->select<false>(m_select1, rank);
+        }
+
+        [[nodiscard]] auto select0(size_type rank) const noexcept -> size_type {
+            return this->select<true>(m_select0, rank);
+        }
+
+        [[nodiscard]] auto next_one(size_type pos) const noexcept -> size_type {
+            size_type word = pos / 64;
+            std::uint64_t bits = m_high[word] & (~std::uint64_t{ 0 } << (pos % 64));
+            while (bits == 0) {
+                bits = m_high[++word];
+            }
+            return word * 64 + detail::count_trailing_zeros(bits);
+        }
+
+        [[nodiscard]] auto lower_bound_index(key_type key) const noexcept -> size_type {
+            if (empty() || key > m_max_key) {
+                return size();
+            }
+
+            // NOTE(Dedrick): Keys sharing the high bits h live between the (h-1)-th and the
+            // h-th zero, so two selects bound the bucket and only the low bits are searched.
+            key_type const high = key >> m_low_bits;
+            key_type const low = m_low_bits == 64 ? key : key & ((std::uint64_t{ 1 } << m_low_bits) - 1);
+            size_type first = high == 0 ? 0 : this->select0(static_cast<size_type>(high - 1)) - static_cast<size_type>(high - 1);
+            size_type last = this->select0(static_cast<size_type>(high)) - static_cast<size_type>(high);
+            while (first < last) {
+                size_type const mid = first + (last - first) / 2;
+                if (this->get_low(mid) < low) {
+                    first = mid + 1;
+                } else {
+                    last = mid;
+                }
+            }
+            return first;
+        }
+    };
+
+    /**
+     * \brief Maps half-open key ranges [lo, hi) to values, e.g. IP ranges or time
+     * ranges. Stored as a flat_map of boundaries, where each boundary starts an
+     * interval that extends to the next boundary. Adjacent intervals with equal
+     * values are coalesced, so T must be equality comparable.
+     * 
+     * \code
+     * dk::flat_interval_map<std::uint32_t, int> map;
+     * map.assign(10, 20, 1);
+     * int const *value = map.find(15); // Points to 1.
+     * \endcode
+     */
+    template <
+        typename Key, typename T,
+        typename Compare = std::less<Key>>
+    class flat_interval_map {
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using key_compare = Compare;
+        using boundary_map = flat_map<key_type, std::optional<mapped_type>, key_compare>;
+        using size_type = typename boundary_map::size_type;
+        using const_iterator = typename boundary_map::const_iterator;
+
+    private:
+        boundary_map m_boundaries;
+
+    public:
+        flat_interval_map() = default;
+
+        /**
+         * \brief Builds the map from unsorted (lo, hi, value) tuples. Where
+         * intervals overlap, later ones take precedence as if assigned in order.
+         */
+        template <typename Iter>
+        flat_interval_map(Iter first, Iter last) {
+            using std::get;
+            std::vector<std::tuple<key_type, key_type, mapped_type>> intervals(first, last);
+
+            // NOTE(Dedrick): Sort indices rather than the intervals so the original order is
+            // still there for the fallback, the input range may only be readable once.
+            std::vector<std::size_t> order(intervals.size());
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                order[i] = i;
+            }
+            std::stable_sort(std::begin(order), std::end(order), [&intervals](std::size_t a, std::size_t b) {
+                return key_compare()(get<0>(intervals[a]), get<0>(intervals[b]));
+            });
+
+            // NOTE(Dedrick): Overlapping input needs precedence resolution, fall back to
+            // assigning in the original order.
+            for (std::size_t i = 1; i < order.size(); ++i) {
+                if (key_compare()(get<0>(intervals[order[i]]), get<1>(intervals[order[i - 1]]))) {
+                    for (auto &interval : intervals) {
+                        this->assign(get<0>(interval), get<1>(interval), std::move(get<2>(interval)));
+                    }
+                    return;
+                }
+            }
+
+            typename boundary_map::container boundaries;
+            boundaries.reserve(intervals.size() * 2);
+            for (std::size_t const index : order) {
+                auto &interval = intervals[index];
+                key_type &lo = get<0>(interval);
+                key_type &hi = get<1>(interval);
+                if (!key_compare()(lo, hi)) {
+                    continue;
+                }
+                if (!boundaries.empty() && !key_compare()(boundaries.back().first, lo)) {
+                    boundaries.pop_back(); // Touching intervals share the boundary.
+                }
+                if (boundaries.empty() || boundaries.back().second != get<2>(interval)) {
+                    boundaries.emplace_back(std::move(lo), std::move(get<2>(interval)));
+                }
+                boundaries.emplace_back(std::move(hi), std::nullopt);
+            }
+            m_boundaries.replace(std::move(boundaries));
+        }
+
+        [[nodiscard]] auto begin() const noexcept -> const_iterator {
+            return m_boundaries.begin();
+        }
+
+        [[nodiscard]] auto end() const noexcept -> const_iterator {
+            return m_boundaries.end();
+        }
+
+        [[nodiscard]] auto empty() const noexcept -> bool {
+            return m_boundaries.empty();
+        }
+
+        /**
+         * \brief Gets the number of boundaries, including those ending an interval.
+         */
+        [[nodiscard]] auto size() const noexcept -> size_type {
+            return m_boundaries.size();
+        }
+
+        auto clear() noexcept -> void {
+            m_boundaries.clear();
+        }
+
+        /**
+         * \brief Gets the value of the interval containing key, or nullptr.
+         */
+        [[nodiscard]] auto find(key_type const &key) const -> mapped_type const* {
+            auto const it = m_boundaries.upper_bound(key);
+            if (it == m_boundaries.begin()) {
+                return nullptr;
+            }
+            auto const &value = std::prev(it)->second;
+            return value ? &*value : nullptr;
+        }
+
+        [[nodiscard]] auto contains(key_type const &key) const -> bool {
+            return this->find(key) != nullptr;
+        }
+
+        auto at(key_type const &key) const -> mapped_type const& {
+            mapped_type const *const value = this->find(key);
+            if (value == nullptr) {
+                throw std::out_of_range("flat_interval_map::at: key not in any interval");
+            }
+            return *value;
+        }
+
+        /**
+         * \brief Sets every key in [lo, hi) to value. Does nothing if hi <= lo.
+         */
+        auto assign(key_type const &lo, key_type const &hi, mapped_type value) -> void {
+            this->splice(lo, hi, std::optional<mapped_type>(std::move(value)));
+        }
+
+        /**
+         * \brief Unmaps every key in [lo, hi).
+         */
+        auto erase(key_type const &lo, key_type const &hi) -> void {
+            this->splice(lo, hi, std::nullopt);
+        }
+
+    private:
+        auto splice(key_type const &lo, key_type const &hi, std::optional<mapped_type> value) -> void {
+            if (!key_compare()(lo, hi)) {
+                return;
+            }
+
+            // NOTE(Dedrick): Boundaries in [lo, hi] are replaced by at most two new ones,
+            // one starting value at lo and one restoring the previous value at hi.
+            auto slot = m_boundaries.lower_bound(lo);
+            auto const last = m_boundaries.upper_bound(hi);
+            bool const emit_lo = slot == m_boundaries.begin()
+                ? value.has_value()
+                : std::prev(slot)->second != value;
+            std::optional<mapped_type> after = last == m_boundaries.begin()
+                ? std::nullopt
+                : std::prev(last)->second;
+            bool const emit_hi = after != value;
+
+            // NOTE(Dedrick): Overwrite the old slots in place, then shift the tail once.
+            auto const old_count = std::distance(slot, last);
+            decltype(std::distance(slot, last)) written = 0;
+            auto const write = [&](key_type const &key, std::optional<mapped_type> &&v) {
+                if (written++ < old_count) {
+                    slot->first = key;
+                    slot->second = std::move(v);
+                    ++slot;
+                } else {
+                    m_boundaries.try_emplace(key, std::move(v));
+                }
+            };
+            if (emit_lo) {
+                write(lo, std::move(value));
+            }
+            if (emit_hi) {
+                write(hi, std::move(after));
+            }
+            if (written < old_count) {
+                m_boundaries.erase(slot, last);
+            }
+        }
+    };
+
+    /**
+     * \brief A flat map for time-keyed data that is appended in key order and
+     * expired from the front. Erasing a prefix only advances a head offset and
+     * appending a key greater than the last is amortized O(1). Lookups binary
+     * search the live window as in flat_map.
+     * 
+     * Expired elements are destroyed in bulk once they outnumber the live ones,
+     * so the backing array holds at most about twice the live window.
+     * 
+     * \code
+     * dk::sliding_flat_map<std::uint64_t, sample> window;
+     * window.try_emplace(now, value);
+     * window.erase_before(now - retention);
+     * \endcode
+     */
+    template <
+        typename Key, typename T,
+        typename Compare = std::less<Key>,
+        typename Container = std::vector<std::pair<Key, T>>>
+    class sliding_flat_map {
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<key_type, mapped_type>;
+        using key_compare = Compare;
+        using container = Container;
+        using size_type = typename container::size_type;
+        using iterator = typename container::iterator;
+        using const_iterator = typename container::const_iterator;
+
+    private:
+        container m_container;
+        size_type m_head = 0;
+
+    public:
+        sliding_flat_map() = default;
+
+        [[nodiscard]] auto begin() noexcept -> iterator {
+            return std::begin(m_container) + static_cast<std::ptrdiff_t>(m_head);
+        }
+
+        [[nodiscard]] auto end() noexcept -> iterator {
+            return std::end(m_container);
+        }
+
+        [[nodiscard]] auto begin() const noexcept -> const_iterator {
+            return std::begin(m_container) + static_cast<std::ptrdiff_t>(m_head);
+        }
+
+        [[nodiscard]] auto end() const noexcept -> const_iterator {
+            return std::end(m_container);
+        }
+
+        [[nodiscard]] auto empty() const noexcept -> bool {
+            return m_head == m_container.size();
+        }
+
+        [[nodiscard]] auto size() const noexcept -> size_type {
+            return m_container.size() - m_head;
+        }
+
+        auto operator[](key_type const &key) -> mapped_type& {
+            return this->try_emplace(key).first->second;
+        }
+
+        /**
+         * \brief Inserts if key is absent. Appending past the last key is amortized
+         * O(1), inserting anywhere else shifts the tail as in flat_map.
+         */
+        template <typename... Args>
+        auto try_emplace(key_type const &key, Args &&...args) -> std::pair<iterator, bool> {
+            if (this->empty() || key_compare()(m_container.back().first, key)) {
+                m_container.emplace_back(
+                    std::piecewise_construct,
+                    std::forward_as_tuple(key),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+                return std::make_pair(std::prev(std::end(m_container)), true);
+            }
+            auto it = this->lower_bound(key);
+            if (it == end() || key_compare()(key, it->first)) {
+                it = m_container.emplace(
+                    it,
+                    std::piecewise_construct,
+                    std::forward_as_tuple(key),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+                return std::make_pair(it, true);
+            }
+            return std::make_pair(it, false);
+        }
+
+        /**
+         * \brief Erases every element with a key less than cutoff in O(lg n).
+         * \return Number of elements erased.
+         */
+        auto erase_before(key_type const &cutoff) -> size_type {
+            auto const it = this->lower_bound(cutoff);
+            auto const count = static_cast<size_type>(std::distance(begin(), it));
+            this->advance_head(count);
+            return count;
+        }
+
+        auto pop_front() -> void {
+            DK_ASSERT(!this->empty()); // pop_front() called for empty map.
+
+            this->advance_head(1);
+        }
+
+        auto erase(const_iterator first, const_iterator last) -> iterator {
+            DK_ASSERT(first <= last); // Invalid range.
+
+            if (first == static_cast<const_iterator>(begin())) {
+                auto const count = static_cast<size_type>(std::distance(first, last));
+                this->advance_head(count);
+                return begin();
+            }
+            return m_container.erase(first, last);
+        }
+
+        auto erase(key_type const &key) -> size_type {
+            auto const it = this->find(key);
+            if (it == end()) {
+                return 0;
+            }
+            this->erase(it, std::next(it));
+            return 1;
+        }
+
+        auto clear() noexcept -> void {
+            m_container.clear();
+            m_head = 0;
+        }
+
+        [[nodiscard]] auto find(key_type const &key) -> iterator {
+            auto const it = this->lower_bound(key);
+            return it != end() && !key_compare()(key, it->first) ? it : end();
+        }
+
+        [[nodiscard]] auto find(key_type const &key) const -> const_iterator {
+            auto const it = this->lower_bound(key);
+            return it != end() && !key_compare()(key, it->first) ? it : end();
+        }
+
+        [[nodiscard]] auto contains(key_type const &key) const -> bool {
+            return this->find(key) != end();
+        }
+
+        [[nodiscard]] auto lower_bound(key_type const &key) -> iterator {
+            return std::lower_bound(begin(), end(), key, compare_op());
+        }
+
+        [[nodiscard]] auto lower_bound(key_type const &key) const -> const_iterator {
+            return std::lower_bound(begin(), end(), key, compare_op());
+        }
+
+        [[nodiscard]] auto upper_bound(key_type const &key) -> iterator {
+            return std::upper_bound(begin(), end(), key, compare_op());
+        }
+
+        [[nodiscard]] auto upper_bound(key_type const &key) const -> const_iterator {
+            return std::upper_bound(begin(), end(), key, compare_op());
+        }
+
+    private:
+        struct compare_op {
+            auto operator()(value_type const &value, key_type const &key) const noexcept -> bool {
+                return key_compare()(value.first, key);
+            }
+
+            auto operator()(key_type const &key, value_type const &value) const noexcept -> bool {
+                return key_compare()(key, value.first);
+            }
+        };
+
+        auto advance_head(size_type count) -> void {
+            DK_ASSERT(count <= this->size()); // Erasing more elements than there are.
+
+            m_head += count;
+            if (m_head == m_container.size()) {
+                this->clear();
+            } else if (m_head > this->size()) {
+                // NOTE(Dedrick): Expired elements outnumber live ones, so moving the live
+                // window to the front costs less than what was erased since the last time.
+                m_container.erase(std::begin(m_container), std::begin(m_container) + static_cast<std::ptrdiff_t>(m_head));
+                m_head = 0;
+            }
+        }
+    };
+
+    /**
+     * \brief A fixed set of worker threads for the parallel flat_map algorithms.
+     * Creating threads is far more expensive than a parallel pass over a map, so
+     * create a pool once and reuse it.
+     * 
+     * \note run() is not reentrant, a task must not call run() on its own pool.
+     */
+    class thread_pool {
+    private:
+        using invoke_fn = void (*)(void *, std::size_t);
+
+        std::vector<std::thread> m_threads;
+        std::mutex m_run_mutex;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        invoke_fn m_invoke = nullptr;
+        void *m_context = nullptr;
+        std::size_t m_count = 0;
+        std::atomic<std::size_t> m_next{ 0 };
+        std::size_t m_active = 0;
+        std::uint64_t m_generation = 0;
+        std::exception_ptr m_error;
+        bool m_stop = false;
+
+    public:
+        /**
+         * \brief Creates a pool where run() executes tasks on `threads` threads,
+         * counting the calling thread. 0 uses the hardware concurrency.
+         */
+        explicit thread_pool(unsigned threads = 0) {
+            if (threads == 0) {
+                threads = std::thread::hardware_concurrency();
+            }
+            if (threads > 1) {
+                m_threads.reserve(threads - 1);
+                try {
+                    for (unsigned i = 1; i < threads; ++i) {
+                        m_threads.emplace_back([this] { this->worker(); });
+                    }
+                } catch (...) {
+                    // NOTE(Dedrick): The destructor does not run for a throwing constructor,
+                    // so the threads already started must be joined here.
+                    this->stop();
+                    throw;
+                }
+            }
+        }
+
+        thread_pool(thread_pool const &) = delete;
+
+        thread_pool& operator=(thread_pool const &) = delete;
+
+        ~thread_pool() {
+            this->stop();
+        }
+
+        /**
+         * \brief Gets the number of threads that execute tasks, including the caller.
+         */
+        [[nodiscard]] auto size() const noexcept -> std::size_t {
+            return m_threads.size() + 1;
+        }
+
+        /**
+         * \brief Calls fn(i) for every i in [0, count) across the pool and blocks
+         * until all calls returned. The calling thread takes part. If any call
+         * throws, the first exception is rethrown once all calls finished.
+         */
+        template <typename Fn>
+        auto run(std::size_t count, Fn &&fn) -> void {
+            if (count == 0) {
+                return;
+            }
+            if (m_threads.empty() || count == 1) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    fn(i);
+                }
+                return;
+            }
+
+            std::lock_guard<std::mutex> run_lock(m_run_mutex);
+            using fn_type = std::remove_reference_t<Fn>;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_invoke = [](void *context, std::size_t i) { (*static_cast<fn_type *>(context))(i); };
+                m_context = const_cast<void *>(static_cast<void const *>(std::addressof(fn)));
+                m_count = count;
+                m_next.store(0, std::memory_order_relaxed);
+                m_active = m_threads.size();
+                m_error = nullptr;
+                ++m_generation;
+            }
+            m_wake.notify_all();
+
+            this->drain();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this] { return m_active == 0; });
+            if (m_error) {
+                std::rethrow_exception(std::exchange(m_error, nullptr));
+            }
+        }
+
+    private:
+        auto stop() noexcept -> void {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            for (std::thread &thread : m_threads) {
+                thread.join();
+            }
+        }
+
+        auto worker() -> void {
+            std::uint64_t seen = 0;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+                    if (m_stop) {
+                        return;
+                    }
+                    seen = m_generation;
+                }
+
+                this->drain();
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_active == 0) {
+                    m_done.notify_one();
+                }
+            }
+        }
+
+        auto drain() -> void {
+            for (;;) {
+                std::size_t const i = m_next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= m_count) {
+                    return;
+                }
+                try {
+                    m_invoke(m_context, i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_error) {
+                        m_error = std::current_exception();
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * \brief Calls fn(key, a_value, b_value) for every key present in both maps,
+     * in parallel. Both maps are split at evenly spaced keys of the larger map and
+     * each partition is merge-joined independently, galloping over runs of keys
+     * only present in one map.
+     * 
+     * fn is called concurrently from several threads, but never twice for the
+     * same key. The order of calls is unspecified.
+     */
+    template <typename MapA, typename MapB, typename Fn>
+    auto parallel_join(MapA &a, MapB &b, Fn fn, thread_pool &pool) -> void {
+        using key_type = typename std::remove_const_t<MapA>::key_type;
+        using key_compare = typename std::remove_const_t<MapA>::key_compare;
+        static_assert(std::is_same_v<key_type, typename std::remove_const_t<MapB>::key_type>); // Key types must match.
+        static_assert(std::is_same_v<key_compare, typename std::remove_const_t<MapB>::key_compare>); // Orders must match.
+
+        auto const comp = [](auto const &value, key_type const &key) {
+            return key_compare()(value.first, key);
+        };
+
+        std::size_t const a_size = static_cast<std::size_t>(a.size());
+        std::size_t const b_size = static_cast<std::size_t>(b.size());
+        if (a_size == 0 || b_size == 0) {
+            return;
+        }
+
+        // NOTE(Dedrick): A few partitions per thread so uneven key density balances out.
+        std::size_t const larger = a_size > b_size ? a_size : b_size;
+        std::size_t const wanted = pool.size() * 4;
+        std::size_t const parts = larger < wanted ? 1 : wanted;
+
+        pool.run(parts, [&](std::size_t part) {
+            // NOTE(Dedrick): Partition boundaries are the keys at evenly spaced indices
+            // of the larger map, located in the smaller map with lower_bound.
+            auto const bound = [&](auto &map, bool is_larger, std::size_t index) {
+                if (index == 0) {
+                    return std::begin(map);
+                }
+                if (index == parts) {
+                    return std::end(map);
+                }
+                auto const split = static_cast<std::ptrdiff_t>(larger * index / parts);
+                if (is_larger) {
+                    return std::begin(map) + split;
+                }
+                key_type const &key = a_size >= b_size
+                    ? (std::begin(a) + split)->first
+                    : (std::begin(b) + split)->first;
+                return std::lower_bound(std::begin(map), std::end(map), key, comp);
+            };
+
+            auto it_a = bound(a, a_size >= b_size, part);
+            auto const end_a = bound(a, a_size >= b_size, part + 1);
+            auto it_b = bound(b, a_size < b_size, part);
+            auto const end_b = bound(b, a_size < b_size, part + 1);
+
+            while (it_a != end_a && it_b != end_b) {
+                if (key_compare()(it_a->first, it_b->first)) {
+                    it_a = detail::gallop_lower_bound(it_a, end_a, it_a, it_b->first, comp);
+                } else if (key_compare()(it_b->first, it_a->first)) {
+                    it_b = detail::gallop_lower_bound(it_b, end_b, it_b, it_a->first, comp);
+                } else {
+                    fn(it_a->first, it_a->second, it_b->second);
+                    ++it_a;
+                    ++it_b;
+                }
+            }
+        });
+    }
+
+    template <typename MapA, typename MapB, typename Fn>
+    auto parallel_join(MapA &a, MapB &b, Fn fn, unsigned threads) -> void {
+        thread_pool pool(threads);
+        dk::parallel_join(a, b, std::move(fn), pool);
+    }
+
+    namespace detail {
+        // NOTE(Dedrick): Splits [0, count) into chunks of whole cache lines, a few per
+        // thread, so neighbouring threads do not write to the same line unless elements
+        // straddle lines.
+        struct chunk_plan {
+            std::size_t head;
+            std::size_t grain;
+            std::size_t chunks;
+
+            [[nodiscard]] auto begin(std::size_t chunk, std::size_t count) const noexcept -> std::size_t {
+                if (chunk == 0) {
+                    return 0;
+                }
+                std::size_t const start = head + (chunk - 1) * grain;
+                return start < count ? start : count;
+            }
+        };
+
+        template <typename Iter>
+        [[nodiscard]] auto make_chunk_plan(Iter first, std::size_t count, std::size_t threads) -> chunk_plan {
+            using value_type = typename std::iterator_traits<Iter>::value_type;
+            constexpr std::size_t line_size = 64;
+            constexpr std::size_t per_line = sizeof(value_type) >= line_size ? 1 : line_size / sizeof(value_type);
+            constexpr std::size_t min_grain = 4096 / sizeof(value_type) + 1;
+
+            std::size_t grain = count / (threads * 4) + 1;
+            grain = grain < min_grain ? min_grain : grain;
+            grain = (grain + per_line - 1) / per_line * per_line;
+
+            // NOTE(Dedrick): For contiguous storage, end the first chunk at the first whole
+            // element past a cache line boundary. Later chunks are whole lines long, so they
+            // start on a line when elements are aligned to their size. When alignof is less
+            // than sizeof, e.g. std::pair<std::uint32_t, std::uint64_t>, elements can straddle
+            // lines, and each chunk then starts just past one, sharing it with its neighbour.
+            std::size_t head = grain;
+            if (count != 0 && line_size % sizeof(value_type) == 0) {
+                auto const addr = reinterpret_cast<std::uintptr_t>(std::addressof(*first));
+                std::size_t const head_bytes = grain * sizeof(value_type) - addr % line_size;
+                head = (head_bytes + sizeof(value_type) - 1) / sizeof(value_type);
+            }
+            std::size_t const chunks = count <= head ? 1 : 1 + (count - head + grain - 1) / grain;
+            return chunk_plan{ head, grain, count == 0 ? 0 : chunks };
+        }
+    }
+
+    /**
+     * \brief Calls fn(element) for every element of [first, last) in parallel.
+     * Works on a whole map or a key range such as
+     * [map.lower_bound(lo), map.lower_bound(hi)).
+     */
+    template <typename Iter, typename Fn>
+    auto parallel_for_each(Iter first, Iter last, Fn fn, thread_pool &pool) -> void {
+        auto const count = static_cast<std::size_t>(std::distance(first, last));
+        detail::chunk_plan const plan = detail::make_chunk_plan(first, count, pool.size());
+        pool.run(plan.chunks, [&](std::size_t chunk) {
+            Iter it = first + static_cast<std::ptrdiff_t>(plan.begin(chunk, count));
+            Iter const end = first + static_cast<std::ptrdiff_t>(plan.begin(chunk + 1, count));
+            for (; it != end; ++it) {
+                fn(*it);
+            }
+        });
+    }
+
+    template <typename Map, typename Fn>
+    auto parallel_for_each(Map &map, Fn fn, thread_pool &pool) -> void {
+        dk::parallel_for_each(std::begin(map), std::end(map), std::move(fn), pool);
+    }
+
+    /**
+     * \brief Computes reduce(init, transform(element)...) over [first, last) in
+     * parallel. reduce must be associative, partial results are combined in order
+     * so a non-commutative reduce still gives a deterministic result.
+     */
+    template <typename Iter, typename T, typename Reduce, typename Transform>
+    [[nodiscard]] auto parallel_transform_reduce(
+        Iter first, Iter last, T init, Reduce reduce, Transform transform, thread_pool &pool) -> T {
+        auto const count = static_cast<std::size_t>(std::distance(first, last));
+        detail::chunk_plan const plan = detail::make_chunk_plan(first, count, pool.size());
+        if (plan.chunks == 0) {
+            return init;
+        }
+
+        std::vector<T> partials(plan.chunks, init);
+        pool.run(plan.chunks, [&](std::size_t chunk) {
+            Iter it = first + static_cast<std::ptrdiff_t>(plan.begin(chunk, count));
+            Iter const end = first + static_cast<std::ptrdiff_t>(plan.begin(chunk + 1, count));
+            if (it == end) {
+                return;
+            }
+            T partial = transform(*it);
+            for (++it; it != end; ++it) {
+                partial = reduce(std::move(partial), transform(*it));
+            }
+            partials[chunk] = std::move(partial);
+        });
+
+        T result = std::move(init);
+        for (std::size_t chunk = 0; chunk < plan.chunks; ++chunk) {
+            if (plan.begin(chunk, count) != plan.begin(chunk + 1, count)) {
+                result = reduce(std::move(result), std::move(partials[chunk]));
+            }
+        }
+        return result;
+    }
+
+    template <typename Map, typename T, typename Reduce, typename Transform>
+    [[nodiscard]] auto parallel_transform_reduce(
+        Map &map, T init, Reduce reduce, Transform transform, thread_pool &pool) -> T {
+        return dk::parallel_transform_reduce(
+            std::begin(map), std::end(map), std::move(init), std::move(reduce), std::move(transform), pool);
+    }
+
+    /**
+     * \brief Counts the elements of [first, last) satisfying pred in parallel.
+     */
+    template <typename Iter, typename Pred>
+    [[nodiscard]] auto parallel_count_if(Iter first, Iter last, Pred pred, thread_pool &pool) -> std::size_t {
+        return dk::parallel_transform_reduce(
+            first, last, std::size_t{ 0 }, std::plus<std::size_t>(),
+            [&pred](auto const &value) -> std::size_t { return pred(value) ? 1 : 0; },
+            pool);
+    }
+
+    template <typename Map, typename Pred>
+    [[nodiscard]] auto parallel_count_if(Map &map, Pred pred, thread_pool &pool) -> std::size_t {
+        return dk::parallel_count_if(std::begin(map), std::end(map), std::move(pred), pool);
+    }
+
+    /**
+     * \brief The difference between two versions of a map, as produced by
+     * dk::diff. Each list is sorted by key.
+     */
+    template <typename Key, typename T>
+    struct flat_map_patch {
+        std::vector<std::pair<Key, T>> inserts;
+        std::vector<std::pair<Key, T>> updates;
+        std::vector<Key> erases;
+
+        [[nodiscard]] auto empty() const noexcept -> bool {
+            return inserts.empty() && updates.empty() && erases.empty();
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t {
+            return inserts.size() + updates.size() + erases.size();
+        }
+    };
+
+    /**
+     * \brief Computes the patch turning old_map into new_map in one linear merge
+     * pass. A key present in both maps is an update when equal(old, new) is false.
+     */
+    template <typename Map, typename Equal = std::equal_to<typename Map::mapped_type>>
+    [[nodiscard]] auto diff(Map const &old_map, Map const &new_map, Equal equal = Equal())
+        -> flat_map_patch<typename Map::key_type, typename Map::mapped_type> {
+        using key_compare = typename Map::key_compare;
+
+        flat_map_patch<typename Map::key_type, typename Map::mapped_type> patch;
+        auto it_old = std::begin(old_map);
+        auto it_new = std::begin(new_map);
+        auto const end_old = std::end(old_map);
+        auto const end_new = std::end(new_map);
+        while (it_old != end_old && it_new != end_new) {
+            if (key_compare()(it_old->first, it_new->first)) {
+                patch.erases.push_back(it_old->first);
+                ++it_old;
+            } else if (key_compare()(it_new->first, it_old->first)) {
+                patch.inserts.push_back(*it_new);
+                ++it_new;
+            } else {
+                if (!equal(it_old->second, it_new->second)) {
+                    patch.updates.push_back(*it_new);
+                }
+                ++it_old;
+                ++it_new;
+            }
+        }
+        for (; it_old != end_old; ++it_old) {
+            patch.erases.push_back(it_old->first);
+        }
+        for (; it_new != end_new; ++it_new) {
+            patch.inserts.push_back(*it_new);
+        }
+        return patch;
+    }
+
+    /**
+     * \brief Applies a patch from dk::diff. A patch of only updates is applied in
+     * place, galloping between the updated keys. Otherwise the map is rebuilt in a
+     * single merge pass. Pass the patch with std::move to move its values in.
+     * 
+     * Inserts of keys already present and updates or erases of missing keys are
+     * treated as assignments and no-ops respectively.
+     */
+    template <typename Map>
+    auto apply_patch(Map &map, flat_map_patch<typename Map::key_type, typename Map::mapped_type> patch) -> void {
+        using key_type = typename Map::key_type;
+        using key_compare = typename Map::key_compare;
+        using container = typename Map::container;
+
+        auto const comp = [](auto const &value, key_type const &key) {
+            return key_compare()(value.first, key);
+        };
+
+        if (patch.inserts.empty() && patch.erases.empty()) {
+            auto it = std::begin(map);
+            auto const end = std::end(map);
+            for (auto &update : patch.updates) {
+                it = detail::gallop_lower_bound(it, end, it, update.first, comp);
+                if (it != end && !key_compare()(update.first, it->first)) {
+                    it->second = std::move(update.second);
+                }
+            }
+            return;
+        }
+
+        container old = std::move(map).extract();
+        container merged;
+        if constexpr (detail::has_reserve<container>::value) {
+            merged.reserve(old.size() + patch.inserts.size());
+        }
+
+        auto ins = std::begin(patch.inserts);
+        auto upd = std::begin(patch.updates);
+        auto era = std::begin(patch.erases);
+        auto const ins_end = std::end(patch.inserts);
+        auto const upd_end = std::end(patch.updates);
+        auto const era_end = std::end(patch.erases);
+        for (auto &value : old) {
+            key_type const &key = value.first;
+            for (; ins != ins_end && key_compare()(ins->first, key); ++ins) {
+                merged.emplace_back(std::move(*ins));
+            }
+            if (ins != ins_end && !key_compare()(key, ins->first)) {
+                // NOTE(Dedrick): Inserting an existing key assigns it.
+                value.second = std::move(ins->second);
+                ++ins;
+            }
+            for (; upd != upd_end && key_compare()(upd->first, key); ++upd) { }
+            if (upd != upd_end && !key_compare()(key, upd->first)) {
+                value.second = std::move(upd->second);
+                ++upd;
+            }
+            for (; era != era_end && key_compare()(*era, key); ++era) { }
+            if (era != era_end && !key_compare()(key, *era)) {
+                ++era;
+                continue;
+            }
+            merged.emplace_back(std::move(value));
+        }
+        for (; ins != ins_end; ++ins) {
+            merged.emplace_back(std::move(*ins));
+        }
+        map.replace(std::move(merged));
+    }
+
+#if defined(DK_INCLUDE_DK_PCG32_H)
+    // NOTE(Dedrick): The sampling functions below are only available when dk_pcg32.h is
+    // included before this header, so that dk_flat_map.hpp stays free of dependencies.
+
+    namespace detail {
+        // NOTE(Dedrick): Uniform index in [0, count), count must be non-zero.
+        [[nodiscard]] inline auto pcg32_index(dk_pcg32 *pcg, std::uint64_t count) -> std::uint64_t {
+            if (count <= 0xFFFFFFFFull) {
+                return dk_pcg32_get_range_u32(pcg, 0, static_cast<std::uint32_t>(count));
+            }
+            std::uint64_t const threshold = (0 - count) % count;
+            for (;;) {
+                std::uint64_t const r = dk_pcg32_get_u64(pcg);
+                if (r >= threshold) {
+                    return r % count;
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Picks a uniformly random element of a flat_map in O(1), or end() if
+     * the map is empty.
+     */
+    template <typename Map>
+    [[nodiscard]] auto random_entry(Map &map, dk_pcg32 *pcg) -> decltype(std::begin(map)) {
+        if (map.empty()) {
+            return std::end(map);
+        }
+        auto const idx = detail::pcg32_index(pcg, static_cast<std::uint64_t>(map.size()));
+        return std::begin(map) + static_cast<std::ptrdiff_t>(idx);
+    }
+
+    /**
+     * \brief Writes iterators to k distinct, uniformly chosen elements of a flat_map
+     * to out, in key order. Uses Floyd's algorithm with a hash set of the picked
+     * ranks, so each pick is expected O(1), then sorts the ranks once for O(k lg k)
+     * in total regardless of the size of the map. Writes all elements if
+     * k >= size().
+     */
+    template <typename Map, typename OutputIter>
+    auto sample(Map &map, std::size_t k, dk_pcg32 *pcg, OutputIter out) -> OutputIter {
+        auto const count = static_cast<std::uint64_t>(map.size());
+        if (k >= count) {
+            for (auto it = std::begin(map); it != std::end(map); ++it, ++out) {
+                *out = it;
+            }
+            return out;
+        }
+
+        // NOTE(Dedrick): Linear probing set at most half full. Ranks are below count, so
+        // the all ones value marks an empty slot.
+        constexpr std::uint64_t empty_slot = ~std::uint64_t{ 0 };
+        unsigned bits = 4;
+        while ((std::size_t{ 1 } << bits) < k * 2) {
+            ++bits;
+        }
+        std::size_t const mask = (std::size_t{ 1 } << bits) - 1;
+        std::vector<std::uint64_t> slots(mask + 1, empty_slot);
+        auto const try_insert = [&slots, mask, bits](std::uint64_t rank) -> bool {
+            auto slot = static_cast<std::size_t>((rank * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+            for (; slots[slot] != empty_slot; slot = (slot + 1) & mask) {
+                if (slots[slot] == rank) {
+                    return false;
+                }
+            }
+            slots[slot] = rank;
+            return true;
+        };
+
+        std::vector<std::uint64_t> picked;
+        picked.reserve(k);
+        for (std::uint64_t j = count - k; j < count; ++j) {
+            std::uint64_t const t = detail::pcg32_index(pcg, j + 1);
+            if (try_insert(t)) {
+                picked.push_back(t);
+            } else {
+                // NOTE(Dedrick): j is larger than any rank picked so far, so it is new.
+                try_insert(j);
+                picked.push_back(j);
+            }
+        }
+        std::sort(std::begin(picked), std::end(picked));
+        for (std::uint64_t const idx : picked) {
+            *out = std::begin(map) + static_cast<std::ptrdiff_t>(idx);
+            ++out;
+        }
+        return out;
+    }
+
+    /**
+     * \brief Reservoir samples k elements from a range of unknown length in one
+     * pass, for ranges without random access. Writes the sample to out, which must
+     * have room for k elements, and returns the number written.
+     */
+    template <typename InputIter, typename RandomIter>
+    auto reservoir_sample(InputIter first, InputIter last, std::size_t k, dk_pcg32 *pcg, RandomIter out) -> std::size_t {
+        std::uint64_t seen = 0;
+        for (; first != last; ++first, ++seen) {
+            if (seen < k) {
+                out[static_cast<std::ptrdiff_t>(seen)] = *first;
+                continue;
+            }
+            std::uint64_t const j = detail::pcg32_index(pcg, seen + 1);
+            if (j < k) {
+                out[static_cast<std::ptrdiff_t>(j)] = *first;
+            }
+        }
+        return static_cast<std::size_t>(seen < k ? seen : k);
+    }
+
+    /**
+     * \brief Picks elements of a flat_map with probability proportional to a weight,
+     * using a prefix sum side array built once in O(n). Each pick is one random
+     * number and a binary search over the prefix sums.
+     * 
+     * The sampler refers to the map, rebuild it after the map is modified.
+     * 
+     * \code
+     * dk::weighted_sampler sampler(map, [](auto const &entry) { return entry.second.traffic; });
+     * auto const canary = sampler.pick(&pcg);
+     * \endcode
+     */
+    template <typename Map>
+    class weighted_sampler {
+    public:
+        using iterator = decltype(std::begin(std::declval<Map&>()));
+
+    private:
+        Map *m_map;
+        std::vector<double> m_prefix;
+
+    public:
+        template <typename WeightFn>
+        weighted_sampler(Map &map, WeightFn weight) :
+            m_map{ &map } {
+            m_prefix.reserve(static_cast<std::size_t>(map.size()));
+            double total = 0.0;
+            for (auto const &entry : map) {
+                double const w = static_cast<double>(weight(entry));
+                total += w > 0.0 ? w : 0.0;
+                m_prefix.push_back(total);
+            }
+        }
+
+        [[nodiscard]] auto total_weight() const noexcept -> double {
+            return m_prefix.empty() ? 0.0 : m_prefix.back();
+        }
+
+        /**
+         * \brief Picks an element, or end() if all weights are zero.
+         */
+        [[nodiscard]] auto pick(dk_pcg32 *pcg) const -> iterator {
+            double const total = this->total_weight();
+            if (!(total > 0.0)) {
+                return std::end(*m_map);
+            }
+            double const target = dk_pcg32_get_f64(pcg) * total;
+            auto const it = std::upper_bound(std::begin(m_prefix), std::end(m_prefix), target);
+            auto const idx = it == std::end(m_prefix)
+                ? m_prefix.size() - 1
+                : static_cast<std::size_t>(std::distance(std::begin(m_prefix), it));
+            return std::begin(*m_map) + static_cast<std::ptrdiff_t>(idx);
+        }
+    };
+#endif // DK_INCLUDE_DK_PCG32_H
+}
+
+namespace std {
+    template <typename... Ts>
+    struct hash<dk::packed_key<Ts...>> {
+        auto operator()(dk::packed_key<Ts...> const &key) const noexcept -> std::size_t {
+            return static_cast<std::size_t>(key.low() ^ (key.high() * 0x9E3779B97F4A7C15ull));
+        }
+    };
 }
 
 /**
  * Revision History:
+ *     0.36 (2026-10-18) add random_entry(), sample(), reservoir_sample() and weighted_sampler;
+ *     0.35 (2026-10-18) emplace() and insert() search before constructing the mapped value;
+ *     0.34 (2026-10-18) add packed_key for composite integer keys;
+ *     0.33 (2026-10-18) add rank(), rank_batch(), nth(), index_of(), quantile() and count_range();
+ *     0.32 (2026-10-18) add capacity(), reserve(), shrink_to_fit() and Growth parameter;
+ *     0.31 (2026-10-18) add sliding_flat_map;
+ *     0.30 (2026-10-18) add flat_interval_map;
+ *     0.29 (2026-10-18) add replace(), extract(), diff() and apply_patch();
+ *     0.28 (2026-10-18) add parallel_for_each, parallel_transform_reduce and parallel_count_if;
+ *     0.27 (2026-10-18) add thread_pool and parallel_join;
+ *     0.26 (2026-10-18) add cursor for galloping search from the last position;
+ *     0.25 (2026-10-18) add Filter parameter and blocked_bloom_filter;
+ *     0.24 (2026-10-18) add elias_fano_map for frozen 64-bit integer keys;
+ *     0.23 (2026-10-18) add huge_page_allocator and get_allocator();
+ *     0.22 (2026-10-18) add memmove fast path for trivially relocatable insert/erase;
  *     0.21 (2025-09-28) change header guard macro to DK_INCLUDE_DK_FLAT_MAP_HPP;
  *     0.2 (2025-02-03) add reserve();
  *     0.1 (2025-02-03) first version;
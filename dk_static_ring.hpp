@@ -0,0 +1,960 @@
+/**
+ * \file dk_static_ring.hpp - v0.1
+ * \author KOH Swee Teck Dedrick
+ * \brief
+ *      A circular buffer with a fixed capacity and stack-based
+ *      allocation.
+ * 
+ *      The container provides an interface similar to std::deque but does
+ *      not perform any dynamic memory allocation. Its capacity is
+ *      determined at compile-time and must be a power of two, so wrapping
+ *      an index is a single mask. Pushing and popping at either end is
+ *      O(1) and never moves the other elements.
+ * 
+ *      The elements occupy at most two contiguous runs of the buffer.
+ *      first_span() and second_span() expose them in order, and for
+ *      trivially copyable element types free_first_span(),
+ *      free_second_span() and commit_back() let data be written straight
+ *      into the free slots, so bulk I/O is at most two memcpy calls.
+ * 
+ *      Like static_vector, slots are left uninitialized until used, and in
+ *      C++20 every operation is constexpr and a static_ring of trivially
+ *      copyable elements is itself trivially copyable. Compile-time use
+ *      carries the same limit as static_vector: elements that are not
+ *      trivially constructible and assignable only work on gcc before C++26.
+ * 
+ *  LICENSE
+ *      License information at the end of the header.
+ */
+
+#ifndef DK_INCLUDE_DK_STATIC_RING_HPP
+#define DK_INCLUDE_DK_STATIC_RING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if !defined(DK_ASSERT)
+#   if defined(_MSC_VER)
+#       if !defined(NDEBUG)
+#           include <intrin.h>
+#           define DK_ASSERT(x) do { if (!(x)) { __debugbreak(); } } while(false) /* NOLINT */
+#       else
+#           define DK_ASSERT(x) do { if (!(x)) { (void)(sizeof(x)); } } while(false) /* NOLINT */
+#       endif
+#   else
+#       include <cassert>
+#       define DK_ASSERT(x) assert(x) /* NOLINT */
+#   endif
+#endif
+
+#if !defined(DK_STATIC_RING_CONSTEXPR)
+#   if __cplusplus >= 202002L // C++20
+#       define DK_STATIC_RING_CONSTEXPR constexpr /* NOLINT */
+#   else
+#       define DK_STATIC_RING_CONSTEXPR /* NOLINT */
+#   endif
+#endif
+
+#if !defined(DK_STATIC_RING_REQUIRES)
+#   if __cplusplus >= 202002L // C++20
+#       define DK_STATIC_RING_REQUIRES(x) requires (x) /* NOLINT */
+#   else
+#       define DK_STATIC_RING_REQUIRES(x) /* NOLINT */
+#   endif
+#endif
+
+#if !defined(DK_IS_TRIVIALLY_RELOCATABLE_DEFINED)
+#define DK_IS_TRIVIALLY_RELOCATABLE_DEFINED
+namespace dk {
+    // NOTE(Dedrick): A type is trivially relocatable if moving it to a new address and
+    // abandoning the old storage is equivalent to a memcpy of its bytes. Trivially
+    // copyable types always are. Specialize this for other types to opt them in, e.g.
+    // std::unique_ptr or std::shared_ptr. Be careful with std::string, libstdc++ keeps a
+    // pointer into its own small string buffer and is NOT trivially relocatable.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+    template <typename A, typename B>
+    struct is_trivially_relocatable<std::pair<A, B>> :
+        std::bool_constant<
+            is_trivially_relocatable<A>::value &&
+            is_trivially_relocatable<B>::value> { };
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+}
+#endif // DK_IS_TRIVIALLY_RELOCATABLE_DEFINED
+
+namespace dk {
+    namespace detail {
+        template <typename Iter, typename = void>
+        struct is_ring_iterator : std::false_type { };
+
+        template <typename Iter>
+        struct is_ring_iterator<Iter, std::void_t<typename std::iterator_traits<Iter>::iterator_category>> :
+            std::true_type { };
+
+        template <typename Iter>
+        inline constexpr bool is_ring_iterator_v = is_ring_iterator<Iter>::value;
+
+        // NOTE(Dedrick): Same as uninitialized_array in dk_static_vector.hpp, see the notes there.
+        template <typename T, std::size_t N>
+        union ring_storage {
+            DK_STATIC_RING_CONSTEXPR ring_storage() noexcept {
+#if __cplusplus >= 202002L // C++20
+                if constexpr (std::is_trivially_default_constructible_v<T> && std::is_trivially_copy_assignable_v<T>) {
+                    if (std::is_constant_evaluated()) {
+                        for (std::size_t i = 0; i < N; ++i) {
+                            m_data[i] = T();
+                        }
+                    }
+                }
+#endif
+            }
+
+#if __cplusplus >= 202002L // C++20
+            constexpr ~ring_storage() requires std::is_trivially_destructible_v<T> = default;
+#endif
+
+            DK_STATIC_RING_CONSTEXPR ~ring_storage() DK_STATIC_RING_REQUIRES(!std::is_trivially_destructible_v<T>) { }
+
+            T m_data[N];
+        };
+
+        // NOTE(Dedrick): A contiguous run of the ring, either elements or free slots.
+        template <typename T, typename SizeType>
+        struct ring_span {
+            T *m_data;
+            SizeType m_size;
+
+            [[nodiscard]] constexpr auto data() const noexcept -> T* {
+                return m_data;
+            }
+
+            [[nodiscard]] constexpr auto size() const noexcept -> SizeType {
+                return m_size;
+            }
+
+            [[nodiscard]] constexpr auto empty() const noexcept -> bool {
+                return m_size == 0;
+            }
+
+            [[nodiscard]] constexpr auto begin() const noexcept -> T* {
+                return m_data;
+            }
+
+            [[nodiscard]] constexpr auto end() const noexcept -> T* {
+                return m_data + m_size;
+            }
+        };
+
+        // NOTE(Dedrick): Stores the logical index rather than a slot pointer, so the
+        // iterator can step across the wrap and compare by position.
+        template <typename T, typename SizeType, std::size_t Mask>
+        class ring_iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::remove_const_t<T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            constexpr ring_iterator() noexcept :
+                m_base{ nullptr },
+                m_head{ 0 },
+                m_index{ 0 } { }
+
+            constexpr ring_iterator(T *base, SizeType head, SizeType index) noexcept :
+                m_base{ base },
+                m_head{ head },
+                m_index{ index } { }
+
+            template <typename U, typename = std::enable_if_t<std::is_same_v<U const, T> && !std::is_same_v<U, T>>>
+            constexpr ring_iterator(ring_iterator<U, SizeType, Mask> const &rhs) noexcept :
+                m_base{ rhs.m_base },
+                m_head{ rhs.m_head },
+                m_index{ rhs.m_index } { }
+
+            [[nodiscard]] constexpr auto operator*() const noexcept -> reference {
+                return m_base[(m_head + m_index) & Mask];
+            }
+
+            [[nodiscard]] constexpr auto operator->() const noexcept -> pointer {
+                return &**this;
+            }
+
+            [[nodiscard]] constexpr auto operator[](difference_type n) const noexcept -> reference {
+                return *(*this + n);
+            }
+
+            constexpr auto operator++() noexcept -> ring_iterator& {
+                ++m_index;
+                return *this;
+            }
+
+            constexpr auto operator++(int) noexcept -> ring_iterator {
+                ring_iterator const tmp = *this;
+                ++m_index;
+                return tmp;
+            }
+
+            constexpr auto operator--() noexcept -> ring_iterator& {
+                --m_index;
+                return *this;
+            }
+
+            constexpr auto operator--(int) noexcept -> ring_iterator {
+                ring_iterator const tmp = *this;
+                --m_index;
+                return tmp;
+            }
+
+            constexpr auto operator+=(difference_type n) noexcept -> ring_iterator& {
+                m_index = static_cast<SizeType>(static_cast<difference_type>(m_index) + n);
+                return *this;
+            }
+
+            constexpr auto operator-=(difference_type n) noexcept -> ring_iterator& {
+                return *this += -n;
+            }
+
+            [[nodiscard]] friend constexpr auto operator+(ring_iterator it, difference_type n) noexcept -> ring_iterator {
+                return it += n;
+            }
+
+            [[nodiscard]] friend constexpr auto operator+(difference_type n, ring_iterator it) noexcept -> ring_iterator {
+                return it += n;
+            }
+
+            [[nodiscard]] friend constexpr auto operator-(ring_iterator it, difference_type n) noexcept -> ring_iterator {
+                return it -= n;
+            }
+
+            [[nodiscard]] friend constexpr auto operator-(ring_iterator const &lhs, ring_iterator const &rhs) noexcept -> difference_type {
+                return static_cast<difference_type>(lhs.m_index) - static_cast<difference_type>(rhs.m_index);
+            }
+
+            [[nodiscard]] friend constexpr auto operator==(ring_iterator const &lhs, ring_iterator const &rhs) noexcept -> bool {
+                return lhs.m_index == rhs.m_index;
+            }
+
+            [[nodiscard]] friend constexpr auto operator!=(ring_iterator const &lhs, ring_iterator const &rhs) noexcept -> bool {
+                return lhs.m_index != rhs.m_index;
+            }
+
+            [[nodiscard]] friend constexpr auto operator<(ring_iterator const &lhs, ring_iterator const &rhs) noexcept -> bool {
+                return lhs.m_index < rhs.m_index;
+            }
+
+            [[nodiscard]] friend constexpr auto operator>(ring_iterator const &lhs, ring_iterator const &rhs) noexcept -> bool {
+                return rhs.m_index < lhs.m_index;
+            }
+
+            [[nodiscard]] friend constexpr auto operator<=(ring_iterator const &lhs, ring_iterator const &rhs) noexcept -> bool {
+                return !(rhs.m_index < lhs.m_index);
+            }
+
+            [[nodiscard]] friend constexpr auto operator>=(ring_iterator const &lhs, ring_iterator const &rhs) noexcept -> bool {
+                return !(lhs.m_index < rhs.m_index);
+            }
+
+        private:
+            template <typename U, typename S, std::size_t M>
+            friend class ring_iterator;
+
+            T *m_base;
+            SizeType m_head;
+            SizeType m_index;
+        };
+    }
+
+    template <
+        typename T,
+        std::size_t N,
+        typename SizeType = std::uint32_t>
+    class static_ring {
+    public:
+        using value_type = T;
+        using size_type = SizeType;
+        using reference = value_type&;
+        using const_reference = value_type const&;
+        using pointer = T*;
+        using const_pointer = T const*;
+        using iterator = detail::ring_iterator<T, SizeType, N - 1>;
+        using const_iterator = detail::ring_iterator<T const, SizeType, N - 1>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using span_type = detail::ring_span<T, SizeType>;
+        using const_span_type = detail::ring_span<T const, SizeType>;
+
+        static_assert(std::is_unsigned_v<size_type>); // Must be unsigned integer.
+        static_assert(N > 0 && (N & (N - 1)) == 0); // Capacity must be a power of two.
+        static_assert(N <= std::numeric_limits<size_type>::max()); // Capacity must fit in size_type.
+
+        // NOTE(Dedrick): Trivially copyable elements are copied as raw bytes and can be
+        // written into the free slots directly.
+        static constexpr bool is_trivial = std::is_trivially_copyable_v<value_type>;
+
+        // NOTE(Dedrick): Relocatable elements are moved with memcpy and their old slots
+        // abandoned without running a destructor.
+        static constexpr bool is_relocatable = is_trivially_relocatable_v<value_type>;
+
+    private:
+        static constexpr size_type mask = static_cast<size_type>(N - 1);
+
+        detail::ring_storage<value_type, N> m_storage;
+        size_type m_head;
+        size_type m_size;
+
+    public:
+        DK_STATIC_RING_CONSTEXPR static_ring() noexcept :
+            m_head{ 0 },
+            m_size{ 0 } { }
+
+        DK_STATIC_RING_CONSTEXPR explicit static_ring(size_type count) :
+            m_head{ 0 },
+            m_size{ 0 } {
+            DK_ASSERT(count <= N); // Capacity exceeded.
+
+            for (; m_size < count; ++m_size) {
+                construct(m_storage.m_data + m_size);
+            }
+        }
+
+        DK_STATIC_RING_CONSTEXPR static_ring(size_type count, value_type const &v) :
+            m_head{ 0 },
+            m_size{ 0 } {
+            DK_ASSERT(count <= N); // Capacity exceeded.
+
+            for (; m_size < count; ++m_size) {
+                construct(m_storage.m_data + m_size, v);
+            }
+        }
+
+        DK_STATIC_RING_CONSTEXPR static_ring(std::initializer_list<value_type> list) :
+            static_ring(list.begin(), list.end()) { }
+
+        template <typename InputIt, typename = std::enable_if_t<detail::is_ring_iterator_v<InputIt>>>
+        DK_STATIC_RING_CONSTEXPR static_ring(InputIt first, InputIt last) :
+            m_head{ 0 },
+            m_size{ 0 } {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+
+#if __cplusplus >= 202002L // C++20
+        // NOTE(Dedrick): Defaulted special members make static_ring trivially copyable
+        // when T is. The copy then covers the whole buffer, a fixed size memcpy.
+        constexpr ~static_ring() requires std::is_trivially_destructible_v<T> = default;
+
+        constexpr static_ring(static_ring const &) requires is_trivial = default;
+
+        constexpr static_ring(static_ring &&) requires is_trivial = default;
+
+        constexpr auto operator=(static_ring const &) -> static_ring& requires is_trivial = default;
+
+        constexpr auto operator=(static_ring &&) -> static_ring& requires is_trivial = default;
+#endif
+
+        DK_STATIC_RING_CONSTEXPR ~static_ring() DK_STATIC_RING_REQUIRES(!std::is_trivially_destructible_v<T>) {
+            clear();
+        }
+
+        // NOTE(Dedrick): Copies and moves straighten the elements out to start at slot 0.
+        DK_STATIC_RING_CONSTEXPR static_ring(static_ring const &rhs) DK_STATIC_RING_REQUIRES(!is_trivial) :
+            m_head{ 0 },
+            m_size{ 0 } {
+            if constexpr (is_trivial) {
+                copy_out(m_storage.m_data, rhs);
+                m_size = rhs.m_size;
+            } else {
+                for (auto const &v : rhs) {
+                    construct(m_storage.m_data + m_size, v);
+                    ++m_size;
+                }
+            }
+        }
+
+        DK_STATIC_RING_CONSTEXPR static_ring(static_ring &&rhs) noexcept(std::is_nothrow_move_constructible_v<T>) DK_STATIC_RING_REQUIRES(!is_trivial) :
+            m_head{ 0 },
+            m_size{ 0 } {
+            take_from(rhs);
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto operator=(static_ring const &rhs) -> static_ring& DK_STATIC_RING_REQUIRES(!is_trivial) {
+            if (this != &rhs) {
+                if constexpr (is_trivial) {
+                    copy_out(m_storage.m_data, rhs);
+                    m_head = 0;
+                    m_size = rhs.m_size;
+                } else {
+                    static_ring tmp(rhs);
+                    clear();
+                    take_from(tmp);
+                }
+            }
+            return *this;
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto operator=(static_ring &&rhs) noexcept(std::is_nothrow_move_constructible_v<T>) -> static_ring& DK_STATIC_RING_REQUIRES(!is_trivial) {
+            if (this != &rhs) {
+                clear();
+                take_from(rhs);
+            }
+            return *this;
+        }
+
+        // NOTE(Dedrick): Each ring keeps its head, elements are swapped slot for slot in
+        // logical order.
+        DK_STATIC_RING_CONSTEXPR auto swap(static_ring &rhs)
+            noexcept(
+                std::is_nothrow_move_constructible_v<T> &&
+                std::is_nothrow_swappable_v<T>) -> void {
+            if (this == &rhs) {
+                return;
+            }
+            size_type const max_size = m_size < rhs.m_size ? rhs.m_size : m_size;
+
+            if constexpr (is_relocatable) {
+                if (!is_constant_evaluated()) {
+                    // NOTE(Dedrick): Swap the bytes of the live slots only, in runs that stop
+                    // where either ring wraps, through a small bounce buffer.
+                    size_type lhs_pos = m_head;
+                    size_type rhs_pos = rhs.m_head;
+                    for (size_type done = 0; done < max_size;) {
+                        size_type run = static_cast<size_type>(max_size - done);
+                        run = run < N - lhs_pos ? run : static_cast<size_type>(N - lhs_pos);
+                        run = run < N - rhs_pos ? run : static_cast<size_type>(N - rhs_pos);
+                        swap_bytes(m_storage.m_data + lhs_pos, rhs.m_storage.m_data + rhs_pos, run);
+                        lhs_pos = static_cast<size_type>((lhs_pos + run) & mask);
+                        rhs_pos = static_cast<size_type>((rhs_pos + run) & mask);
+                        done = static_cast<size_type>(done + run);
+                    }
+                    std::swap(m_size, rhs.m_size);
+                    return;
+                }
+            }
+
+            // NOTE(Dedrick): Swap the common elements, then move the longer tail across.
+            size_type const min_size = m_size < rhs.m_size ? m_size : rhs.m_size;
+            for (size_type i = 0; i < min_size; ++i) {
+                std::swap((*this)[i], rhs[i]);
+            }
+            static_ring &longer = m_size < rhs.m_size ? rhs : *this;
+            static_ring &shorter = m_size < rhs.m_size ? *this : rhs;
+            for (size_type i = min_size; i < max_size; ++i) {
+                construct(shorter.m_storage.m_data + shorter.slot(i), std::move(longer[i]));
+            }
+            for (size_type i = min_size; i < max_size; ++i) {
+                destroy(longer.m_storage.m_data + longer.slot(i));
+            }
+            std::swap(m_size, rhs.m_size);
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto begin() noexcept -> iterator {
+            return iterator{ m_storage.m_data, m_head, 0 };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto end() noexcept -> iterator {
+            return iterator{ m_storage.m_data, m_head, m_size };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto begin() const noexcept -> const_iterator {
+            return const_iterator{ m_storage.m_data, m_head, 0 };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto end() const noexcept -> const_iterator {
+            return const_iterator{ m_storage.m_data, m_head, m_size };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto cbegin() const noexcept -> const_iterator {
+            return begin();
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto cend() const noexcept -> const_iterator {
+            return end();
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto rbegin() noexcept -> reverse_iterator {
+            return reverse_iterator{ end() };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto rend() noexcept -> reverse_iterator {
+            return reverse_iterator{ begin() };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto rbegin() const noexcept -> const_reverse_iterator {
+            return const_reverse_iterator{ end() };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto rend() const noexcept -> const_reverse_iterator {
+            return const_reverse_iterator{ begin() };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto crbegin() const noexcept -> const_reverse_iterator {
+            return rbegin();
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto crend() const noexcept -> const_reverse_iterator {
+            return rend();
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto empty() const noexcept -> bool {
+            return m_size == 0;
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto full() const noexcept -> bool {
+            return m_size == N;
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto size() const noexcept -> size_type {
+            return m_size;
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto max_size() const noexcept -> size_type {
+            return static_cast<size_type>(N);
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto capacity() const noexcept -> size_type {
+            return static_cast<size_type>(N);
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto front() noexcept -> reference {
+            DK_ASSERT(!empty()); // front() called for empty ring.
+
+            return m_storage.m_data[m_head];
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto front() const noexcept -> const_reference {
+            DK_ASSERT(!empty()); // front() called for empty ring.
+
+            return m_storage.m_data[m_head];
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto back() noexcept -> reference {
+            DK_ASSERT(!empty()); // back() called for empty ring.
+
+            return m_storage.m_data[slot(m_size - 1)];
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto back() const noexcept -> const_reference {
+            DK_ASSERT(!empty()); // back() called for empty ring.
+
+            return m_storage.m_data[slot(m_size - 1)];
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto operator[](size_type idx) noexcept -> reference {
+            DK_ASSERT(idx < m_size); // Out of bounds.
+
+            return m_storage.m_data[slot(idx)];
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto operator[](size_type idx) const noexcept -> const_reference {
+            DK_ASSERT(idx < m_size); // Out of bounds.
+
+            return m_storage.m_data[slot(idx)];
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto at(size_type idx) -> reference {
+            if (idx >= m_size) {
+                throw std::out_of_range("static_ring::at: index out of range");
+            }
+            return m_storage.m_data[slot(idx)];
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto at(size_type idx) const -> const_reference {
+            if (idx >= m_size) {
+                throw std::out_of_range("static_ring::at: index out of range");
+            }
+            return m_storage.m_data[slot(idx)];
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto push_back(value_type const &v) -> void {
+            emplace_back(v);
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto push_back(value_type &&v) noexcept(noexcept(value_type(std::move(v)))) -> void {
+            emplace_back(std::move(v));
+        }
+
+        template <typename... Args>
+        DK_STATIC_RING_CONSTEXPR auto emplace_back(Args &&...args) noexcept(noexcept(value_type(std::forward<Args>(args)...))) -> reference {
+            DK_ASSERT(!full()); // Capacity exceeded.
+
+            pointer const ptr = construct(m_storage.m_data + slot(m_size), std::forward<Args>(args)...);
+            ++m_size;
+            return *ptr;
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto push_front(value_type const &v) -> void {
+            emplace_front(v);
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto push_front(value_type &&v) noexcept(noexcept(value_type(std::move(v)))) -> void {
+            emplace_front(std::move(v));
+        }
+
+        template <typename... Args>
+        DK_STATIC_RING_CONSTEXPR auto emplace_front(Args &&...args) noexcept(noexcept(value_type(std::forward<Args>(args)...))) -> reference {
+            DK_ASSERT(!full()); // Capacity exceeded.
+
+            size_type const head = static_cast<size_type>((m_head + mask) & mask);
+            pointer const ptr = construct(m_storage.m_data + head, std::forward<Args>(args)...);
+            m_head = head;
+            ++m_size;
+            return *ptr;
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto pop_back() noexcept -> void {
+            DK_ASSERT(!empty()); // pop_back() called for empty ring.
+
+            --m_size;
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                destroy(m_storage.m_data + slot(m_size));
+            }
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto pop_front() noexcept -> void {
+            DK_ASSERT(!empty()); // pop_front() called for empty ring.
+
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                destroy(m_storage.m_data + m_head);
+            }
+            m_head = static_cast<size_type>((m_head + 1) & mask);
+            --m_size;
+            if (m_size == 0) {
+                m_head = 0;
+            }
+        }
+
+        // NOTE(Dedrick): Pops count elements at once, O(1) for trivially destructible types.
+        DK_STATIC_RING_CONSTEXPR auto drop_front(size_type count) noexcept -> void {
+            DK_ASSERT(count <= m_size); // Out of bounds.
+
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (size_type i = 0; i < count; ++i) {
+                    destroy(m_storage.m_data + slot(i));
+                }
+            }
+            m_head = static_cast<size_type>((m_head + count) & mask);
+            m_size -= count;
+            if (m_size == 0) {
+                // NOTE(Dedrick): Rewind so the next writes land in a single span.
+                m_head = 0;
+            }
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto drop_back(size_type count) noexcept -> void {
+            DK_ASSERT(count <= m_size); // Out of bounds.
+
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (size_type i = m_size - count; i < m_size; ++i) {
+                    destroy(m_storage.m_data + slot(i));
+                }
+            }
+            m_size -= count;
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto clear() noexcept -> void {
+            drop_front(m_size);
+        }
+
+        // NOTE(Dedrick): The elements in order are first_span() followed by second_span().
+        // second_span() is empty unless the elements wrap past the end of the buffer.
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto first_span() noexcept -> span_type {
+            return span_type{ m_storage.m_data + m_head, first_count() };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto first_span() const noexcept -> const_span_type {
+            return const_span_type{ m_storage.m_data + m_head, first_count() };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto second_span() noexcept -> span_type {
+            return span_type{ m_storage.m_data, static_cast<size_type>(m_size - first_count()) };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto second_span() const noexcept -> const_span_type {
+            return const_span_type{ m_storage.m_data, static_cast<size_type>(m_size - first_count()) };
+        }
+
+        // NOTE(Dedrick): The free slots after back(), in order, as up to two runs. Write
+        // into them and call commit_back() to make them elements. Only for trivially
+        // copyable types since the slots hold no objects.
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto free_first_span() noexcept -> span_type DK_STATIC_RING_REQUIRES(is_trivial) {
+            static_assert(is_trivial); // Free slots can only be written as raw bytes.
+
+            size_type const tail = slot(m_size);
+            size_type const free = static_cast<size_type>(N - m_size);
+            size_type const to_end = static_cast<size_type>(N - tail);
+            return span_type{ m_storage.m_data + tail, free < to_end ? free : to_end };
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto free_second_span() noexcept -> span_type DK_STATIC_RING_REQUIRES(is_trivial) {
+            static_assert(is_trivial); // Free slots can only be written as raw bytes.
+
+            size_type const tail = slot(m_size);
+            size_type const free = static_cast<size_type>(N - m_size);
+            size_type const to_end = static_cast<size_type>(N - tail);
+            return span_type{ m_storage.m_data, free < to_end ? size_type{ 0 } : static_cast<size_type>(free - to_end) };
+        }
+
+        DK_STATIC_RING_CONSTEXPR auto commit_back(size_type count) noexcept -> void DK_STATIC_RING_REQUIRES(is_trivial) {
+            static_assert(is_trivial); // Free slots can only be written as raw bytes.
+            DK_ASSERT(count <= N - m_size); // Capacity exceeded.
+
+            m_size += count;
+        }
+
+        // NOTE(Dedrick): Appends up to count elements from src with at most two copies.
+        // Returns the number written, less than count when the ring fills up.
+        DK_STATIC_RING_CONSTEXPR auto write_back(const_pointer src, size_type count) noexcept -> size_type DK_STATIC_RING_REQUIRES(is_trivial) {
+            static_assert(is_trivial); // Use push_back for non trivially copyable types.
+
+            size_type const free = static_cast<size_type>(N - m_size);
+            size_type const written = count < free ? count : free;
+            span_type const first = free_first_span();
+            size_type const head_count = written < first.size() ? written : first.size();
+            copy_bytes(first.data(), src, head_count);
+            copy_bytes(m_storage.m_data, src + head_count, static_cast<size_type>(written - head_count));
+            m_size += written;
+            return written;
+        }
+
+        // NOTE(Dedrick): Moves up to count elements from the front into dst with at most two
+        // copies. Returns the number read, less than count when the ring runs empty.
+        DK_STATIC_RING_CONSTEXPR auto read_front(pointer dst, size_type count) noexcept -> size_type DK_STATIC_RING_REQUIRES(is_trivial) {
+            static_assert(is_trivial); // Use front and pop_front for non trivially copyable types.
+
+            size_type const read = count < m_size ? count : m_size;
+            span_type const first = first_span();
+            size_type const head_count = read < first.size() ? read : first.size();
+            copy_bytes(dst, first.data(), head_count);
+            copy_bytes(dst + head_count, m_storage.m_data, static_cast<size_type>(read - head_count));
+            drop_front(read);
+            return read;
+        }
+
+    private:
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto slot(size_type idx) const noexcept -> size_type {
+            return static_cast<size_type>((m_head + idx) & mask);
+        }
+
+        [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto first_count() const noexcept -> size_type {
+            size_type const to_end = static_cast<size_type>(N - m_head);
+            return m_size < to_end ? m_size : to_end;
+        }
+
+        [[nodiscard]] static constexpr auto is_constant_evaluated() noexcept -> bool {
+#if __cplusplus >= 202002L // C++20
+            return std::is_constant_evaluated();
+#else
+            return false;
+#endif
+        }
+
+        template <typename... Args>
+        DK_STATIC_RING_CONSTEXPR static auto construct(pointer p, Args &&...args)
+            noexcept(std::is_nothrow_constructible_v<T, Args...>) -> pointer {
+#if __cplusplus >= 202002L // C++20
+            return std::construct_at(p, std::forward<Args>(args)...);
+#else
+            return new (p) value_type(std::forward<Args>(args)...);
+#endif
+        }
+
+        DK_STATIC_RING_CONSTEXPR static auto destroy(pointer p) noexcept -> void {
+#if __cplusplus >= 202002L // C++20
+            std::destroy_at(p);
+#else
+            p->~value_type();
+#endif
+        }
+
+        DK_STATIC_RING_CONSTEXPR static auto copy_bytes(pointer dst, const_pointer src, size_type count) noexcept -> void {
+            if (is_constant_evaluated()) {
+                for (size_type i = 0; i < count; ++i) {
+                    construct(dst + i, src[i]);
+                }
+            } else if (count != 0) {
+                std::memcpy(static_cast<void *>(dst), static_cast<void const *>(src), sizeof(value_type) * count);
+            }
+        }
+
+        static auto swap_bytes(pointer lhs, pointer rhs, size_type count) noexcept -> void {
+            std::size_t const bytes = static_cast<std::size_t>(count) * sizeof(value_type);
+            auto *const lhs_bytes = reinterpret_cast<unsigned char *>(lhs);
+            auto *const rhs_bytes = reinterpret_cast<unsigned char *>(rhs);
+            unsigned char tmp[256];
+            for (std::size_t offset = 0; offset < bytes; offset += sizeof(tmp)) {
+                std::size_t const chunk = bytes - offset < sizeof(tmp) ? bytes - offset : sizeof(tmp);
+                std::memcpy(tmp, lhs_bytes + offset, chunk);
+                std::memcpy(lhs_bytes + offset, rhs_bytes + offset, chunk);
+                std::memcpy(rhs_bytes + offset, tmp, chunk);
+            }
+        }
+
+        // NOTE(Dedrick): Copies the elements of rhs in order to dst, two runs at most.
+        DK_STATIC_RING_CONSTEXPR static auto copy_out(pointer dst, static_ring const &rhs) noexcept -> void {
+            const_span_type const first = rhs.first_span();
+            const_span_type const second = rhs.second_span();
+            copy_bytes(dst, first.data(), first.size());
+            copy_bytes(dst + first.size(), second.data(), second.size());
+        }
+
+        // NOTE(Dedrick): Moves the elements of rhs to start at slot 0 of this empty ring and
+        // leaves rhs empty.
+        DK_STATIC_RING_CONSTEXPR auto take_from(static_ring &rhs) noexcept(std::is_nothrow_move_constructible_v<T>) -> void {
+            DK_ASSERT(empty());
+
+            m_head = 0;
+            if constexpr (is_relocatable) {
+                if (!is_constant_evaluated()) {
+                    span_type const first = rhs.first_span();
+                    span_type const second = rhs.second_span();
+                    if (first.size() != 0) {
+                        std::memcpy(static_cast<void *>(m_storage.m_data), static_cast<void const *>(first.data()), sizeof(value_type) * first.size());
+                    }
+                    if (second.size() != 0) {
+                        std::memcpy(static_cast<void *>(m_storage.m_data + first.size()), static_cast<void const *>(second.data()), sizeof(value_type) * second.size());
+                    }
+                    m_size = rhs.m_size;
+                    rhs.m_head = 0;
+                    rhs.m_size = 0;
+                    return;
+                }
+            }
+            for (auto &v : rhs) {
+                construct(m_storage.m_data + m_size, std::move(v));
+                ++m_size;
+            }
+            rhs.clear();
+        }
+    };
+
+    template <typename T, std::size_t N, typename SizeType>
+    [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto operator==(
+        static_ring<T, N, SizeType> const &lhs,
+        static_ring<T, N, SizeType> const &rhs
+    ) -> bool {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+#if __cplusplus >= 202002L // C++20
+    template <typename T, std::size_t N, typename SizeType>
+    [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto operator<=>(
+        static_ring<T, N, SizeType> const &lhs,
+        static_ring<T, N, SizeType> const &rhs
+    ) {
+        return std::lexicographical_compare_three_way(
+            lhs.begin(), lhs.end(),
+            rhs.begin(), rhs.end());
+    }
+#else
+    template <typename T, std::size_t N, typename SizeType>
+    [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto operator!=(
+        static_ring<T, N, SizeType> const &lhs,
+        static_ring<T, N, SizeType> const &rhs
+    ) -> bool {
+        return !(lhs == rhs);
+    }
+
+    template <typename T, std::size_t N, typename SizeType>
+    [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto operator<(
+        static_ring<T, N, SizeType> const &lhs,
+        static_ring<T, N, SizeType> const &rhs
+    ) -> bool {
+        return std::lexicographical_compare(
+            lhs.begin(), lhs.end(),
+            rhs.begin(), rhs.end());
+    }
+
+    template <typename T, std::size_t N, typename SizeType>
+    [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto operator<=(
+        static_ring<T, N, SizeType> const &lhs,
+        static_ring<T, N, SizeType> const &rhs
+    ) -> bool {
+        return !(rhs < lhs);
+    }
+
+    template <typename T, std::size_t N, typename SizeType>
+    [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto operator>(
+        static_ring<T, N, SizeType> const &lhs,
+        static_ring<T, N, SizeType> const &rhs
+    ) -> bool {
+        return rhs < lhs;
+    }
+
+    template <typename T, std::size_t N, typename SizeType>
+    [[nodiscard]] DK_STATIC_RING_CONSTEXPR auto operator>=(
+        static_ring<T, N, SizeType> const &lhs,
+        static_ring<T, N, SizeType> const &rhs
+    ) -> bool {
+        return !(lhs < rhs);
+    }
+#endif // __cplusplus >= 202002L
+}
+
+/**
+ * Revision History:
+ *     0.1 (2026-10-18) first version;
+ */
+
+/**
+ * This software is available under two licenses (A) or (B) - chose whichever
+ * you prefer.
+ * ---
+ * (A) zlib License
+ *
+ * Copyright (C) 2026 KOH Swee Teck Dedrick
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 
+ * ---
+ * (B) MIT License
+ * 
+ * Copyright (C) 2026 KOH Swee Teck Dedrick
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#endif // DK_INCLUDE_DK_STATIC_RING_HPP
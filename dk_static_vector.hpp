@@ -1,5 +1,5 @@
 /**
- * \file dk_static_vector.hpp - v0.1
+ * \file dk_static_vector.hpp - v0.10
  * \author KOH Swee Teck Dedrick
  * \brief
  *      An std::vector like container with a fixed capacity and
@@ -9,137 +9,1705 @@
  *      but does not perform any dynamic memory allocation. Its
  *      capacity is determined at compile-time.
  * 
+ *      Construction never touches the unused part of the buffer. For
+ *      trivially copyable element types, swaps, inserts and erases are done
+ *      with memcpy/memmove of the live elements, and so are copies and
+ *      moves in C++17. In C++20 the vector is itself trivially copyable
+ *      instead, so it can be memcpy'd and held by other trivially copyable
+ *      types, but a copy or move then covers the whole buffer rather than
+ *      size() elements. Define
+ *      DK_STATIC_VECTOR_COPY_SIZE_ONLY to copy only the live elements and
+ *      give up trivial copyability. Inserts, erases, swaps
+ *      and reallocations also relocate with memmove for any type marked
+ *      dk::is_trivially_relocatable, such as std::unique_ptr.
+ * 
+ *      For arithmetic elements, find, count, contains, index_of,
+ *      min_element and max_element use SSE2 or AVX2 kernels on x86, with
+ *      AVX2 picked at runtime. Define DK_STATIC_VECTOR_NO_SIMD to always use
+ *      the scalar std algorithms.
+ * 
+ *      static_vector takes an optional Alignment, e.g. 32 or 64, that
+ *      aligns data() and pads the buffer to a multiple of that many bytes.
+ *      Whole SIMD blocks can then be read up to padded_capacity() with no
+ *      scalar tail, as long as the lanes past size() are masked off.
+ * 
+ *      Elements live in a union of an uninitialized array, so in C++20
+ *      every operation is constexpr and a static_vector can be built and
+ *      used during constant evaluation. That holds on every compiler for
+ *      trivially constructible and assignable elements. Other element types
+ *      need C++26 trivial unions and only work at compile time on gcc.
+ * 
+ *      small_vector shares the same implementation, but instead of
+ *      asserting when full it spills to the heap through an allocator.
+ *      Up to N elements are stored inline and never allocate.
+ * 
  *  LICENSE
  *      License information at the end of the header.
  */
 
-#ifndef DK_INCLUDE_DK_STATIC_VECTOR_HPP
-#define DK_INCLUDE_DK_STATIC_VECTOR_HPP
+#ifndef DK_INCLUDE_DK_STATIC_VECTOR_HPP
+#define DK_INCLUDE_DK_STATIC_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if !defined(DK_ASSERT)
+#   if defined(_MSC_VER)
+#       if !defined(NDEBUG)
+#           include <intrin.h>
+#           define DK_ASSERT(x) do { if (!(x)) { __debugbreak(); } } while(false) /* NOLINT */
+#       else
+#           define DK_ASSERT(x) do { if (!(x)) { (void)(sizeof(x)); } } while(false) /* NOLINT */
+#       endif
+#   else
+#       include <cassert>
+#       define DK_ASSERT(x) assert(x) /* NOLINT */
+#   endif
+#endif
+
+#if !defined(DK_STATIC_VECTOR_CONSTEXPR)
+#   if __cplusplus >= 202002L // C++20
+#       define DK_STATIC_VECTOR_CONSTEXPR constexpr /* NOLINT */
+#   else
+#       define DK_STATIC_VECTOR_CONSTEXPR /* NOLINT */
+#   endif
+#endif
+
+#if !defined(DK_STATIC_VECTOR_REQUIRES)
+#   if __cplusplus >= 202002L // C++20
+#       define DK_STATIC_VECTOR_REQUIRES(x) requires (x) /* NOLINT */
+#   else
+#       define DK_STATIC_VECTOR_REQUIRES(x) /* NOLINT */
+#   endif
+#endif
+
+#if !defined(DK_STATIC_VECTOR_NO_SIMD)
+#   if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define DK_STATIC_VECTOR_SSE2
+#       include <immintrin.h>
+#       if defined(_MSC_VER) && !defined(__clang__)
+#           include <intrin.h>
+#           define DK_STATIC_VECTOR_TARGET_AVX2 /* NOLINT */
+#       else
+#           define DK_STATIC_VECTOR_TARGET_AVX2 __attribute__((target("avx2"))) /* NOLINT */
+#       endif
+#   endif
+#endif
+
+#if !defined(DK_IS_TRIVIALLY_RELOCATABLE_DEFINED)
+#define DK_IS_TRIVIALLY_RELOCATABLE_DEFINED
+namespace dk {
+    // NOTE(Dedrick): A type is trivially relocatable if moving it to a new address and
+    // abandoning the old storage is equivalent to a memcpy of its bytes. Trivially
+    // copyable types always are. Specialize this for other types to opt them in, e.g.
+    // std::unique_ptr or std::shared_ptr. Be careful with std::string, libstdc++ keeps a
+    // pointer into its own small string buffer and is NOT trivially relocatable.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+    template <typename A, typename B>
+    struct is_trivially_relocatable<std::pair<A, B>> :
+        std::bool_constant<
+            is_trivially_relocatable<A>::value &&
+            is_trivially_relocatable<B>::value> { };
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+}
+#endif // DK_IS_TRIVIALLY_RELOCATABLE_DEFINED
+
+namespace dk {
+    namespace detail {
+        template <typename Iter, typename = void>
+        struct is_iterator : std::false_type { };
+
+        template <typename Iter>
+        struct is_iterator<Iter, std::void_t<typename std::iterator_traits<Iter>::iterator_category>> :
+            std::true_type { };
+
+        template <typename Iter>
+        inline constexpr bool is_iterator_v = is_iterator<Iter>::value;
+
+        template <typename Iter>
+        inline constexpr bool is_forward_iterator_v = std::is_base_of_v<
+            std::forward_iterator_tag,
+            typename std::iterator_traits<Iter>::iterator_category>;
+
+        // NOTE(Dedrick): Yields the same value forever, so a fill can reuse the range insert.
+        template <typename T>
+        struct repeat_iterator {
+            T const *m_value;
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto operator*() const noexcept -> T const& {
+                return *m_value;
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto operator++() noexcept -> repeat_iterator& {
+                return *this;
+            }
+        };
+
+        // NOTE(Dedrick): Search kernels for arithmetic elements. x86 always has SSE2, AVX2 is
+        // picked at runtime. Other platforms and constant evaluation use the std algorithms.
+        template <typename T>
+        inline constexpr bool is_simd_searchable_v =
+#if defined(DK_STATIC_VECTOR_SSE2)
+            std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+            (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+#else
+            false;
+#endif
+
+#if defined(DK_STATIC_VECTOR_SSE2)
+        [[nodiscard]] inline auto simd_popcount(std::uint32_t x) noexcept -> int {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcount(x);
+#else
+            x = x - ((x >> 1) & 0x55555555u);
+            x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+            x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+            return static_cast<int>((x * 0x01010101u) >> 24);
+#endif
+        }
+
+        // NOTE(Dedrick): x must be non-zero.
+        [[nodiscard]] inline auto simd_count_trailing_zeros(std::uint32_t x) noexcept -> int {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctz(x);
+#else
+            unsigned long idx;
+            _BitScanForward(&idx, x);
+            return static_cast<int>(idx);
+#endif
+        }
+
+        // NOTE(Dedrick): Byte mask of the lanes of a block that hold the remaining elements.
+        template <typename T, std::size_t Lanes>
+        [[nodiscard]] inline auto simd_tail_mask(std::size_t remaining) noexcept -> std::uint32_t {
+            return remaining >= Lanes ? ~0u : (1u << (remaining * sizeof(T))) - 1u;
+        }
+
+        [[nodiscard]] inline auto has_avx2() noexcept -> bool {
+#if defined(__AVX2__)
+            return true;
+#elif defined(_MSC_VER) && !defined(__clang__)
+            static bool const value = [] {
+                int info[4];
+                __cpuid(info, 0);
+                if (info[0] < 7) {
+                    return false;
+                }
+                __cpuid(info, 1);
+                bool const os_saves_ymm =
+                    (info[2] & (1 << 27)) != 0 &&
+                    (info[2] & (1 << 28)) != 0 &&
+                    (_xgetbv(0) & 6) == 6;
+                __cpuidex(info, 7, 0);
+                return os_saves_ymm && (info[1] & (1 << 5)) != 0;
+            }();
+            return value;
+#else
+            static bool const value = [] {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") != 0;
+            }();
+            return value;
+#endif
+        }
+
+        template <typename T>
+        [[nodiscard]] inline auto sse2_splat(T value) noexcept -> __m128i {
+            if constexpr (std::is_same_v<T, float>) {
+                return _mm_castps_si128(_mm_set1_ps(value));
+            } else if constexpr (std::is_same_v<T, double>) {
+                return _mm_castpd_si128(_mm_set1_pd(value));
+            } else if constexpr (sizeof(T) == 1) {
+                return _mm_set1_epi8(static_cast<char>(value));
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_set1_epi16(static_cast<short>(value));
+            } else if constexpr (sizeof(T) == 4) {
+                return _mm_set1_epi32(static_cast<int>(value));
+            } else {
+                return _mm_set1_epi64x(static_cast<long long>(value));
+            }
+        }
+
+        // NOTE(Dedrick): One bit per byte, so a matching element sets sizeof(T) bits.
+        template <typename T>
+        [[nodiscard]] inline auto sse2_equal_mask(__m128i block, __m128i needle) noexcept -> std::uint32_t {
+            __m128i eq;
+            if constexpr (std::is_same_v<T, float>) {
+                eq = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(block), _mm_castsi128_ps(needle)));
+            } else if constexpr (std::is_same_v<T, double>) {
+                eq = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(block), _mm_castsi128_pd(needle)));
+            } else if constexpr (sizeof(T) == 1) {
+                eq = _mm_cmpeq_epi8(block, needle);
+            } else if constexpr (sizeof(T) == 2) {
+                eq = _mm_cmpeq_epi16(block, needle);
+            } else if constexpr (sizeof(T) == 4) {
+                eq = _mm_cmpeq_epi32(block, needle);
+            } else {
+                // NOTE(Dedrick): SSE2 has no 64-bit compare, so both 32-bit halves must match.
+                __m128i const halves = _mm_cmpeq_epi32(block, needle);
+                eq = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+            }
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+        }
+
+        template <typename T>
+        inline constexpr bool sse2_has_min_max_v =
+            std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::int16_t> ||
+            std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+        template <typename T, bool Max>
+        [[nodiscard]] inline auto sse2_min_max(__m128i a, __m128i b) noexcept -> __m128i {
+            if constexpr (std::is_same_v<T, float>) {
+                __m128 const x = _mm_castsi128_ps(a);
+                __m128 const y = _mm_castsi128_ps(b);
+                return _mm_castps_si128(Max ? _mm_max_ps(x, y) : _mm_min_ps(x, y));
+            } else if constexpr (std::is_same_v<T, double>) {
+                __m128d const x = _mm_castsi128_pd(a);
+                __m128d const y = _mm_castsi128_pd(b);
+                return _mm_castpd_si128(Max ? _mm_max_pd(x, y) : _mm_min_pd(x, y));
+            } else if constexpr (std::is_same_v<T, std::uint8_t>) {
+                return Max ? _mm_max_epu8(a, b) : _mm_min_epu8(a, b);
+            } else {
+                return Max ? _mm_max_epi16(a, b) : _mm_min_epi16(a, b);
+            }
+        }
+
+        template <typename T>
+        [[nodiscard]] inline auto sse2_nan_mask(__m128i block) noexcept -> __m128i {
+            if constexpr (std::is_same_v<T, float>) {
+                __m128 const x = _mm_castsi128_ps(block);
+                return _mm_castps_si128(_mm_cmpunord_ps(x, x));
+            } else if constexpr (std::is_same_v<T, double>) {
+                __m128d const x = _mm_castsi128_pd(block);
+                return _mm_castpd_si128(_mm_cmpunord_pd(x, x));
+            } else {
+                return _mm_setzero_si128();
+            }
+        }
+
+        template <typename T>
+        [[nodiscard]] DK_STATIC_VECTOR_TARGET_AVX2 inline auto avx2_splat(T value) noexcept -> __m256i {
+            if constexpr (std::is_same_v<T, float>) {
+                return _mm256_castps_si256(_mm256_set1_ps(value));
+            } else if constexpr (std::is_same_v<T, double>) {
+                return _mm256_castpd_si256(_mm256_set1_pd(value));
+            } else if constexpr (sizeof(T) == 1) {
+                return _mm256_set1_epi8(static_cast<char>(value));
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm256_set1_epi16(static_cast<short>(value));
+            } else if constexpr (sizeof(T) == 4) {
+                return _mm256_set1_epi32(static_cast<int>(value));
+            } else {
+                return _mm256_set1_epi64x(static_cast<long long>(value));
+            }
+        }
+
+        template <typename T>
+        [[nodiscard]] DK_STATIC_VECTOR_TARGET_AVX2 inline auto avx2_equal_mask(__m256i block, __m256i needle) noexcept -> std::uint32_t {
+            __m256i eq;
+            if constexpr (std::is_same_v<T, float>) {
+                eq = _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(block), _mm256_castsi256_ps(needle), _CMP_EQ_OQ));
+            } else if constexpr (std::is_same_v<T, double>) {
+                eq = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(block), _mm256_castsi256_pd(needle), _CMP_EQ_OQ));
+            } else if constexpr (sizeof(T) == 1) {
+                eq = _mm256_cmpeq_epi8(block, needle);
+            } else if constexpr (sizeof(T) == 2) {
+                eq = _mm256_cmpeq_epi16(block, needle);
+            } else if constexpr (sizeof(T) == 4) {
+                eq = _mm256_cmpeq_epi32(block, needle);
+            } else {
+                eq = _mm256_cmpeq_epi64(block, needle);
+            }
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+        }
+
+        template <typename T>
+        inline constexpr bool avx2_has_min_max_v =
+            std::is_floating_point_v<T> || (std::is_integral_v<T> && sizeof(T) <= 4);
+
+        template <typename T, bool Max>
+        [[nodiscard]] DK_STATIC_VECTOR_TARGET_AVX2 inline auto avx2_min_max(__m256i a, __m256i b) noexcept -> __m256i {
+            if constexpr (std::is_same_v<T, float>) {
+                __m256 const x = _mm256_castsi256_ps(a);
+                __m256 const y = _mm256_castsi256_ps(b);
+                return _mm256_castps_si256(Max ? _mm256_max_ps(x, y) : _mm256_min_ps(x, y));
+            } else if constexpr (std::is_same_v<T, double>) {
+                __m256d const x = _mm256_castsi256_pd(a);
+                __m256d const y = _mm256_castsi256_pd(b);
+                return _mm256_castpd_si256(Max ? _mm256_max_pd(x, y) : _mm256_min_pd(x, y));
+            } else if constexpr (sizeof(T) == 1) {
+                if constexpr (std::is_signed_v<T>) {
+                    return Max ? _mm256_max_epi8(a, b) : _mm256_min_epi8(a, b);
+                } else {
+                    return Max ? _mm256_max_epu8(a, b) : _mm256_min_epu8(a, b);
+                }
+            } else if constexpr (sizeof(T) == 2) {
+                if constexpr (std::is_signed_v<T>) {
+                    return Max ? _mm256_max_epi16(a, b) : _mm256_min_epi16(a, b);
+                } else {
+                    return Max ? _mm256_max_epu16(a, b) : _mm256_min_epu16(a, b);
+                }
+            } else {
+                if constexpr (std::is_signed_v<T>) {
+                    return Max ? _mm256_max_epi32(a, b) : _mm256_min_epi32(a, b);
+                } else {
+                    return Max ? _mm256_max_epu32(a, b) : _mm256_min_epu32(a, b);
+                }
+            }
+        }
+
+        template <typename T>
+        [[nodiscard]] DK_STATIC_VECTOR_TARGET_AVX2 inline auto avx2_nan_mask(__m256i block) noexcept -> __m256i {
+            if constexpr (std::is_same_v<T, float>) {
+                __m256 const x = _mm256_castsi256_ps(block);
+                return _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+            } else if constexpr (std::is_same_v<T, double>) {
+                __m256d const x = _mm256_castsi256_pd(block);
+                return _mm256_castpd_si256(_mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+            } else {
+                return _mm256_setzero_si256();
+            }
+        }
+
+        // NOTE(Dedrick): When Padded, data is aligned to a block and readable up to a whole
+        // number of blocks, so the last block is loaded in full and its extra lanes masked off.
+        template <typename T, bool Padded = false>
+        [[nodiscard]] inline auto sse2_find(T const *data, std::size_t count, T value) noexcept -> std::size_t {
+            constexpr std::size_t lanes = sizeof(__m128i) / sizeof(T);
+            __m128i const needle = sse2_splat(value);
+            std::size_t i = 0;
+            if constexpr (Padded) {
+                for (; i < count; i += lanes) {
+                    __m128i const block = _mm_load_si128(reinterpret_cast<__m128i const *>(data + i));
+                    std::uint32_t const mask = sse2_equal_mask<T>(block, needle) & simd_tail_mask<T, lanes>(count - i);
+                    if (mask != 0) {
+                        return i + static_cast<std::size_t>(simd_count_trailing_zeros(mask)) / sizeof(T);
+                    }
+                }
+                return count;
+            }
+            for (; i + lanes <= count; i += lanes) {
+                __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i));
+                std::uint32_t const mask = sse2_equal_mask<T>(block, needle);
+                if (mask != 0) {
+                    return i + static_cast<std::size_t>(simd_count_trailing_zeros(mask)) / sizeof(T);
+                }
+            }
+            for (; i < count; ++i) {
+                if (data[i] == value) {
+                    return i;
+                }
+            }
+            return count;
+        }
+
+        // NOTE(Dedrick): When Padded, data is aligned to a block and readable up to a whole
+        // number of blocks, so the last block is loaded in full and its extra lanes masked off.
+        template <typename T, bool Padded = false>
+        [[nodiscard]] DK_STATIC_VECTOR_TARGET_AVX2 inline auto avx2_find(T const *data, std::size_t count, T value) noexcept -> std::size_t {
+            constexpr std::size_t lanes = sizeof(__m256i) / sizeof(T);
+            __m256i const needle = avx2_splat(value);
+            std::size_t i = 0;
+            if constexpr (Padded) {
+                for (; i < count; i += lanes) {
+                    __m256i const block = _mm256_load_si256(reinterpret_cast<__m256i const *>(data + i));
+                    std::uint32_t const mask = avx2_equal_mask<T>(block, needle) & simd_tail_mask<T, lanes>(count - i);
+                    if (mask != 0) {
+                        return i + static_cast<std::size_t>(simd_count_trailing_zeros(mask)) / sizeof(T);
+                    }
+                }
+                return count;
+            }
+            for (; i + lanes <= count; i += lanes) {
+                __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + i));
+                std::uint32_t const mask = avx2_equal_mask<T>(block, needle);
+                if (mask != 0) {
+                    return i + static_cast<std::size_t>(simd_count_trailing_zeros(mask)) / sizeof(T);
+                }
+            }
+            for (; i < count; ++i) {
+                if (data[i] == value) {
+                    return i;
+                }
+            }
+            return count;
+        }
+
+        template <typename T, bool Padded = false>
+        [[nodiscard]] inline auto sse2_count(T const *data, std::size_t count, T value) noexcept -> std::size_t {
+            constexpr std::size_t lanes = sizeof(__m128i) / sizeof(T);
+            __m128i const needle = sse2_splat(value);
+            std::size_t bits = 0;
+            std::size_t i = 0;
+            if constexpr (Padded) {
+                for (; i < count; i += lanes) {
+                    __m128i const block = _mm_load_si128(reinterpret_cast<__m128i const *>(data + i));
+                    std::uint32_t const mask = sse2_equal_mask<T>(block, needle) & simd_tail_mask<T, lanes>(count - i);
+                    bits += static_cast<std::size_t>(simd_popcount(mask));
+                }
+                return bits / sizeof(T);
+            }
+            for (; i + lanes <= count; i += lanes) {
+                __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i));
+                bits += static_cast<std::size_t>(simd_popcount(sse2_equal_mask<T>(block, needle)));
+            }
+            std::size_t result = bits / sizeof(T);
+            for (; i < count; ++i) {
+                result += data[i] == value;
+            }
+            return result;
+        }
+
+        template <typename T, bool Padded = false>
+        [[nodiscard]] DK_STATIC_VECTOR_TARGET_AVX2 inline auto avx2_count(T const *data, std::size_t count, T value) noexcept -> std::size_t {
+            constexpr std::size_t lanes = sizeof(__m256i) / sizeof(T);
+            __m256i const needle = avx2_splat(value);
+            std::size_t bits = 0;
+            std::size_t i = 0;
+            if constexpr (Padded) {
+                for (; i < count; i += lanes) {
+                    __m256i const block = _mm256_load_si256(reinterpret_cast<__m256i const *>(data + i));
+                    std::uint32_t const mask = avx2_equal_mask<T>(block, needle) & simd_tail_mask<T, lanes>(count - i);
+                    bits += static_cast<std::size_t>(simd_popcount(mask));
+                }
+                return bits / sizeof(T);
+            }
+            for (; i + lanes <= count; i += lanes) {
+                __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + i));
+                bits += static_cast<std::size_t>(simd_popcount(avx2_equal_mask<T>(block, needle)));
+            }
+            std::size_t result = bits / sizeof(T);
+            for (; i < count; ++i) {
+                result += data[i] == value;
+            }
+            return result;
+        }
+
+        // NOTE(Dedrick): Writes the smallest (or largest) value to out. Returns false when a
+        // NaN is seen, since min/max instructions do not order NaN like operator<.
+        template <typename T, bool Max>
+        [[nodiscard]] inline auto sse2_extreme(T const *data, std::size_t count, T &out) noexcept -> bool {
+            constexpr std::size_t lanes = sizeof(__m128i) / sizeof(T);
+            DK_ASSERT(count >= lanes);
+
+            __m128i acc = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data));
+            __m128i nan = sse2_nan_mask<T>(acc);
+            std::size_t i = lanes;
+            for (; i + lanes <= count; i += lanes) {
+                __m128i const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i));
+                acc = sse2_min_max<T, Max>(acc, block);
+                nan = _mm_or_si128(nan, sse2_nan_mask<T>(block));
+            }
+            if (_mm_movemask_epi8(nan) != 0) {
+                return false;
+            }
+
+            T lane[lanes];
+            std::memcpy(lane, &acc, sizeof(acc));
+            T result = lane[0];
+            for (std::size_t j = 1; j < lanes; ++j) {
+                result = (Max ? result < lane[j] : lane[j] < result) ? lane[j] : result;
+            }
+            for (; i < count; ++i) {
+                if (data[i] != data[i]) {
+                    return false;
+                }
+                result = (Max ? result < data[i] : data[i] < result) ? data[i] : result;
+            }
+            out = result;
+            return true;
+        }
+
+        template <typename T, bool Max>
+        [[nodiscard]] DK_STATIC_VECTOR_TARGET_AVX2 inline auto avx2_extreme(T const *data, std::size_t count, T &out) noexcept -> bool {
+            constexpr std::size_t lanes = sizeof(__m256i) / sizeof(T);
+            DK_ASSERT(count >= lanes);
+
+            __m256i acc = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data));
+            __m256i nan = avx2_nan_mask<T>(acc);
+            std::size_t i = lanes;
+            for (; i + lanes <= count; i += lanes) {
+                __m256i const block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + i));
+                acc = avx2_min_max<T, Max>(acc, block);
+                nan = _mm256_or_si256(nan, avx2_nan_mask<T>(block));
+            }
+            if (_mm256_movemask_epi8(nan) != 0) {
+                return false;
+            }
+
+            T lane[lanes];
+            std::memcpy(lane, &acc, sizeof(acc));
+            T result = lane[0];
+            for (std::size_t j = 1; j < lanes; ++j) {
+                result = (Max ? result < lane[j] : lane[j] < result) ? lane[j] : result;
+            }
+            for (; i < count; ++i) {
+                if (data[i] != data[i]) {
+                    return false;
+                }
+                result = (Max ? result < data[i] : data[i] < result) ? data[i] : result;
+            }
+            out = result;
+            return true;
+        }
+#endif // DK_STATIC_VECTOR_SSE2
+
+        // NOTE(Dedrick): Index of the first element equal to value, or count if none. Padding
+        // is the alignment of data, which must also be readable up to a multiple of it.
+        template <typename T, std::size_t Padding = 0>
+        [[nodiscard]] inline auto simd_find(T const *data, std::size_t count, T value) noexcept -> std::size_t {
+#if defined(DK_STATIC_VECTOR_SSE2)
+            if constexpr (Padding >= sizeof(__m256i)) {
+                if (has_avx2()) {
+                    return avx2_find<T, true>(data, count, value);
+                }
+            }
+            if (count >= sizeof(__m256i) / sizeof(T) && has_avx2()) {
+                return avx2_find(data, count, value);
+            }
+            return sse2_find<T, (Padding >= sizeof(__m128i))>(data, count, value);
+#else
+            return static_cast<std::size_t>(std::find(data, data + count, value) - data);
+#endif
+        }
+
+        template <typename T, std::size_t Padding = 0>
+        [[nodiscard]] inline auto simd_count(T const *data, std::size_t count, T value) noexcept -> std::size_t {
+#if defined(DK_STATIC_VECTOR_SSE2)
+            if constexpr (Padding >= sizeof(__m256i)) {
+                if (has_avx2()) {
+                    return avx2_count<T, true>(data, count, value);
+                }
+            }
+            if (count >= sizeof(__m256i) / sizeof(T) && has_avx2()) {
+                return avx2_count(data, count, value);
+            }
+            return sse2_count<T, (Padding >= sizeof(__m128i))>(data, count, value);
+#else
+            return static_cast<std::size_t>(std::count(data, data + count, value));
+#endif
+        }
+
+        // NOTE(Dedrick): Index of the first smallest (or largest) element, the same one
+        // std::min_element (or std::max_element) picks. count must be non-zero.
+        template <typename T, bool Max>
+        [[nodiscard]] inline auto simd_extreme(T const *data, std::size_t count) noexcept -> std::size_t {
+            auto const scalar = [data, count] {
+                T const *const it = Max ? std::max_element(data, data + count) : std::min_element(data, data + count);
+                return static_cast<std::size_t>(it - data);
+            };
+#if defined(DK_STATIC_VECTOR_SSE2)
+            if constexpr (avx2_has_min_max_v<T>) {
+                if (count >= sizeof(__m256i) / sizeof(T) && has_avx2()) {
+                    T value{ };
+                    return avx2_extreme<T, Max>(data, count, value) ? simd_find(data, count, value) : scalar();
+                }
+            }
+            if constexpr (sse2_has_min_max_v<T>) {
+                if (count >= sizeof(__m128i) / sizeof(T)) {
+                    T value{ };
+                    return sse2_extreme<T, Max>(data, count, value) ? simd_find(data, count, value) : scalar();
+                }
+            }
+#endif
+            return scalar();
+        }
+
+        // NOTE(Dedrick): A union leaves the array uninitialized without resorting to a
+        // byte buffer, which keeps element access free of reinterpret_cast in constexpr.
+        template <typename T, std::size_t N>
+        union uninitialized_array {
+            DK_STATIC_VECTOR_CONSTEXPR uninitialized_array() noexcept {
+#if __cplusplus >= 202002L // C++20
+                // NOTE(Dedrick): Constant evaluation only lets construct_at reuse slots of the
+                // active union member. Assigning through m_data makes the array active, and
+                // filling every slot keeps a partly used container a valid constant. Types
+                // without trivial construction and assignment cannot be activated this way
+                // before C++26, so only gcc evaluates those at compile time.
+                if constexpr (std::is_trivially_default_constructible_v<T> && std::is_trivially_copy_assignable_v<T>) {
+                    if (std::is_constant_evaluated()) {
+                        for (std::size_t i = 0; i < N; ++i) {
+                            m_data[i] = T();
+                        }
+                    }
+                }
+#endif
+            }
+
+#if __cplusplus >= 202002L // C++20
+            constexpr ~uninitialized_array() requires std::is_trivially_destructible_v<T> = default;
+#endif
+
+            DK_STATIC_VECTOR_CONSTEXPR ~uninitialized_array() DK_STATIC_VECTOR_REQUIRES(!std::is_trivially_destructible_v<T>) { }
+
+            T m_data[N];
+        };
+
+        // NOTE(Dedrick): The element algorithms shared by static_vector and small_vector.
+        // Derived provides data(), size(), capacity(), set_size() and at_message, the text
+        // at() throws with. When FixedCapacity is
+        // false it also provides grow(min_capacity), which may reallocate, and when it is true
+        // it provides alignment, the block size its storage is aligned and padded to.
+        template <
+            typename Derived,
+            typename T,
+            typename SizeType,
+            bool FixedCapacity>
+        class vector_base {
+        public:
+            using value_type = T;
+            using size_type = SizeType;
+            using reference = value_type&;
+            using const_reference = value_type const&;
+            using pointer = T*;
+            using const_pointer = T const*;
+            using iterator = T*;
+            using const_iterator = T const*;
+            using reverse_iterator = std::reverse_iterator<iterator>;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+            static_assert(std::is_unsigned_v<size_type>); // Must be unsigned integer.
+
+            // NOTE(Dedrick): noexcept(noexcept(expression)) follows this idiom from Raymond Chen.
+            // https://devblogs.microsoft.com/oldnewthing/20220408-00/?p=106438
+
+            // NOTE(Dedrick): Trivially copyable elements are copied and shifted as raw bytes.
+            static constexpr bool is_trivial = std::is_trivially_copyable_v<value_type>;
+
+            // NOTE(Dedrick): Relocatable elements are shifted with memmove and their old slots
+            // abandoned without running a destructor.
+            static constexpr bool is_relocatable = is_trivially_relocatable_v<value_type>;
+
+            // NOTE(Dedrick): Inserting never allocates when the capacity is fixed.
+            static constexpr bool is_fixed_capacity = FixedCapacity;
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto begin() noexcept -> iterator {
+                return iterator{ self().data() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto end() noexcept -> iterator {
+                return iterator{ self().data() + self().size() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto begin() const noexcept -> const_iterator {
+                return const_iterator{ self().data() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto end() const noexcept -> const_iterator {
+                return const_iterator{ self().data() + self().size() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto cbegin() const noexcept -> const_iterator {
+                return const_iterator{ begin() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto cend() const noexcept -> const_iterator {
+                return const_iterator{ end() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto rbegin() noexcept -> reverse_iterator {
+                return std::reverse_iterator<iterator>{ end() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto rend() noexcept -> reverse_iterator {
+                return std::reverse_iterator<iterator>{ begin() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto rbegin() const noexcept -> const_reverse_iterator {
+                return std::reverse_iterator<const_iterator>{ end() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto rend() const noexcept -> const_reverse_iterator {
+                return std::reverse_iterator<const_iterator>{ begin() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto crbegin() const noexcept -> const_reverse_iterator {
+                return std::reverse_iterator<const_iterator>{ end() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto crend() const noexcept -> const_reverse_iterator {
+                return std::reverse_iterator<const_iterator>{ begin() };
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto empty() const noexcept -> bool {
+                return self().size() == 0;
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto front() noexcept -> reference {
+                DK_ASSERT(!empty()); // front() called for empty array.
+
+                return *begin();
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto front() const noexcept -> const_reference {
+                DK_ASSERT(!empty()); // front() called for empty array.
+
+                return *begin();
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto back() noexcept -> reference {
+                DK_ASSERT(!empty()); // back() called for empty array.
+
+                return *(end() - 1);
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto back() const noexcept -> const_reference {
+                DK_ASSERT(!empty()); // back() called for empty array.
+
+                return *(end() - 1);
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto operator[](size_type idx) noexcept -> reference {
+                DK_ASSERT(idx < self().size()); // Out of bounds.
+
+                return self().data()[idx];
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto operator[](size_type idx) const noexcept -> const_reference {
+                DK_ASSERT(idx < self().size()); // Out of bounds.
+
+                return self().data()[idx];
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto at(size_type idx) -> reference {
+                if (idx >= self().size()) {
+                    throw std::out_of_range(Derived::at_message);
+                }
+                return self().data()[idx];
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto at(size_type idx) const -> const_reference {
+                if (idx >= self().size()) {
+                    throw std::out_of_range(Derived::at_message);
+                }
+                return self().data()[idx];
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto index_of(value_type const &value) const -> size_type {
+                if constexpr (is_simd_searchable_v<value_type>) {
+                    if (!is_constant_evaluated()) {
+                        return static_cast<size_type>(simd_find<value_type, padding()>(self().data(), self().size(), value));
+                    }
+                }
+                return static_cast<size_type>(std::find(begin(), end(), value) - begin());
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto find(value_type const &value) -> iterator {
+                return begin() + index_of(value);
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto find(value_type const &value) const -> const_iterator {
+                return begin() + index_of(value);
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto contains(value_type const &value) const -> bool {
+                return index_of(value) != self().size();
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto count(value_type const &value) const -> size_type {
+                if constexpr (is_simd_searchable_v<value_type>) {
+                    if (!is_constant_evaluated()) {
+                        return static_cast<size_type>(simd_count<value_type, padding()>(self().data(), self().size(), value));
+                    }
+                }
+                return static_cast<size_type>(std::count(begin(), end(), value));
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto min_element() -> iterator {
+                return begin() + extreme_index<false>();
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto min_element() const -> const_iterator {
+                return begin() + extreme_index<false>();
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto max_element() -> iterator {
+                return begin() + extreme_index<true>();
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto max_element() const -> const_iterator {
+                return begin() + extreme_index<true>();
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto push_back(value_type const &v) -> void {
+                emplace_back(v);
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto push_back(value_type &&v)
+                noexcept(FixedCapacity && noexcept(value_type(std::move(v)))) -> void {
+                emplace_back(std::move(v));
+            }
+
+            template <typename... Args>
+            DK_STATIC_VECTOR_CONSTEXPR auto emplace_back(Args &&...args)
+                noexcept(FixedCapacity && noexcept(value_type(std::forward<Args>(args)...))) -> reference {
+                if constexpr (!FixedCapacity) {
+                    size_type const count = self().size();
+                    if (count == self().capacity()) {
+                        // NOTE(Dedrick): Build the value before growing since args may alias
+                        // an element that is about to be relocated.
+                        value_type value(std::forward<Args>(args)...);
+                        self().grow(count + 1);
+                        pointer const ptr = construct(self().data() + count, std::move(value));
+                        self().set_size(count + 1);
+                        return *ptr;
+                    }
+                }
+                return unchecked_emplace_back(std::forward<Args>(args)...);
+            }
+
+            // NOTE(Dedrick): The try_ functions never grow. They return null, or the first
+            // element not appended, once the current capacity is used up.
+            template <typename... Args>
+            DK_STATIC_VECTOR_CONSTEXPR auto try_emplace_back(Args &&...args)
+                noexcept(noexcept(value_type(std::forward<Args>(args)...))) -> pointer {
+                if (self().size() == self().capacity()) {
+                    return nullptr;
+                }
+                return &unchecked_emplace_back(std::forward<Args>(args)...);
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto try_push_back(value_type const &v)
+                noexcept(std::is_nothrow_copy_constructible_v<T>) -> pointer {
+                return try_emplace_back(v);
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto try_push_back(value_type &&v)
+                noexcept(std::is_nothrow_move_constructible_v<T>) -> pointer {
+                return try_emplace_back(std::move(v));
+            }
+
+            template <typename Range>
+            DK_STATIC_VECTOR_CONSTEXPR auto try_append_range(Range &&range) {
+                using std::begin;
+                using std::end;
+                auto it = begin(range);
+                auto const last = end(range);
+                size_type const room = self().capacity() - self().size();
+                for (size_type i = 0; i < room && it != last; ++i, ++it) {
+                    unchecked_emplace_back(*it);
+                }
+                return it;
+            }
+
+            // NOTE(Dedrick): The caller guarantees there is room. Only a debug assert checks it.
+            template <typename... Args>
+            DK_STATIC_VECTOR_CONSTEXPR auto unchecked_emplace_back(Args &&...args)
+                noexcept(noexcept(value_type(std::forward<Args>(args)...))) -> reference {
+                size_type const count = self().size();
+                DK_ASSERT(count < self().capacity()); // Vector is full.
+
+                pointer const ptr = construct(self().data() + count, std::forward<Args>(args)...);
+                self().set_size(count + 1);
+                return *ptr;
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto unchecked_push_back(value_type const &v)
+                noexcept(std::is_nothrow_copy_constructible_v<T>) -> reference {
+                return unchecked_emplace_back(v);
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto unchecked_push_back(value_type &&v)
+                noexcept(std::is_nothrow_move_constructible_v<T>) -> reference {
+                return unchecked_emplace_back(std::move(v));
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto pop_back() noexcept -> void {
+                DK_ASSERT(!empty()); // pop_back() called for empty array.
+
+                size_type const new_size = self().size() - 1;
+                if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                    destroy(self().data() + new_size);
+                }
+                self().set_size(new_size);
+            }
+
+            template <typename... Args>
+            DK_STATIC_VECTOR_CONSTEXPR auto emplace(const_iterator pos, Args &&...args)
+                noexcept(
+                    FixedCapacity &&
+                    std::is_nothrow_constructible_v<T, Args...> &&
+                    std::is_nothrow_move_constructible_v<T> &&
+                    std::is_nothrow_move_assignable_v<T>) -> iterator {
+                DK_ASSERT(pos >= cbegin() && pos <= cend()); // Iterator out of bounds.
+
+                size_type const index = static_cast<size_type>(pos - cbegin());
+                size_type const count = self().size();
+
+                if (index == count) {
+                    // NOTE(Dedrick): Inserting at the end is just emplace_back.
+                    emplace_back(std::forward<Args>(args)...);
+                    return begin() + index;
+                }
+
+                // NOTE(Dedrick): Not inserting at the end, so we need to make space.
+                // Build the value first since args may alias an element that is about to move.
+                value_type value(std::forward<Args>(args)...);
+                reserve_for(1);
+                pointer const p_insert = self().data() + index;
+
+                if constexpr (is_relocatable && std::is_nothrow_move_constructible_v<T>) {
+                    // NOTE(Dedrick): Open the gap with a single memmove.
+                    relocate_overlapping(p_insert + 1, p_insert, count - index);
+                    construct(p_insert, std::move(value));
+                } else {
+                    // NOTE(Dedrick): Move construct the last element into the uninitialized space at the new end.
+                    construct(end(), std::move(back()));
+
+                    // NOTE(Dedrick): Shift existing elements one position to the right.
+                    for (iterator it = end() - 1; it > p_insert; --it) {
+                        *it = std::move(*(it - 1));
+                    }
+
+                    // NOTE(Dedrick): Assign the new value to the now moved-from object at the insertion point.
+                    *p_insert = std::move(value);
+                }
+
+                self().set_size(count + 1);
+                return p_insert;
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto insert(const_iterator pos, value_type const &value)
+                noexcept(
+                    FixedCapacity &&
+                    std::is_nothrow_copy_constructible_v<T> &&
+                    std::is_nothrow_move_constructible_v<T> &&
+                    std::is_nothrow_move_assignable_v<T>) -> iterator {
+                return emplace(pos, value);
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto insert(const_iterator pos, value_type &&value)
+                noexcept(
+                    FixedCapacity &&
+                    std::is_nothrow_move_constructible_v<T> &&
+                    std::is_nothrow_move_assignable_v<T>) -> iterator {
+                return emplace(pos, std::move(value));
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto insert(const_iterator pos, size_type count, value_type const &value) -> iterator {
+                DK_ASSERT(pos >= cbegin() && pos <= cend()); // Iterator out of bounds.
+
+                // NOTE(Dedrick): Copy first since value may alias an element that is about to move.
+                value_type const copy(value);
+                return insert_forward(static_cast<size_type>(pos - cbegin()), repeat_iterator<value_type>{ &copy }, count);
+            }
+
+            template <typename InputIt, typename = std::enable_if_t<is_iterator_v<InputIt>>>
+            DK_STATIC_VECTOR_CONSTEXPR auto insert(const_iterator pos, InputIt first, InputIt last) -> iterator {
+                DK_ASSERT(pos >= cbegin() && pos <= cend()); // Iterator out of bounds.
+
+                size_type const index = static_cast<size_type>(pos - cbegin());
+                if constexpr (is_forward_iterator_v<InputIt>) {
+                    return insert_forward(index, first, static_cast<size_type>(std::distance(first, last)));
+                } else {
+                    // NOTE(Dedrick): The length is unknown up front, so append and then rotate
+                    // the new elements into place with one pass.
+                    size_type const count = self().size();
+                    for (; first != last; ++first) {
+                        emplace_back(*first);
+                    }
+                    std::rotate(begin() + index, begin() + count, end());
+                    return begin() + index;
+                }
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto insert(const_iterator pos, std::initializer_list<value_type> list) -> iterator {
+                return insert(pos, list.begin(), list.end());
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto assign(size_type count, value_type const &value) -> void {
+                value_type const copy(value);
+                clear();
+                insert_forward(0, repeat_iterator<value_type>{ &copy }, count);
+            }
+
+            template <typename InputIt, typename = std::enable_if_t<is_iterator_v<InputIt>>>
+            DK_STATIC_VECTOR_CONSTEXPR auto assign(InputIt first, InputIt last) -> void {
+                clear();
+                insert(cend(), first, last);
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto assign(std::initializer_list<value_type> list) -> void {
+                assign(list.begin(), list.end());
+            }
+
+            template <typename Range>
+            DK_STATIC_VECTOR_CONSTEXPR auto append_range(Range &&range) -> void {
+                using std::begin;
+                using std::end;
+                insert(cend(), begin(range), end(range));
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) -> iterator {
+                DK_ASSERT(!empty());
+                DK_ASSERT(pos >= cbegin() && pos < cend());
+
+                // NOTE(Dedrick): Convert const_iterator to a mutable iterator.
+                iterator const it = begin() + (pos - cbegin());
+
+                if constexpr (is_relocatable) {
+                    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                        destroy(it);
+                    }
+                    relocate_overlapping(it, it + 1, static_cast<size_type>(end() - (it + 1)));
+                    self().set_size(self().size() - 1);
+                    return it;
+                }
+
+                // NOTE(Dedrick): Shift all elements after this one to the left.
+                std::move(it + 1, end(), it);
+
+                // NOTE(Dedrick): Destroy the now-duplicate last element and shrink the vector.
+                pop_back();
+
+                return it;
+            }
+
+            // NOTE(Dedrick): Fills the hole with the last element instead of shifting the
+            // tail, so the order of the remaining elements is not kept.
+            DK_STATIC_VECTOR_CONSTEXPR auto erase_unordered(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) -> iterator {
+                DK_ASSERT(!empty());
+                DK_ASSERT(pos >= cbegin() && pos < cend());
+
+                iterator const it = begin() + (pos - cbegin());
+                iterator const last = end() - 1;
+
+                if constexpr (is_relocatable) {
+                    if (it != last) {
+                        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                            destroy(it);
+                        }
+                        relocate(it, last, 1);
+                        self().set_size(self().size() - 1);
+                        return it;
+                    }
+                } else {
+                    if (it != last) {
+                        *it = std::move(*last);
+                    }
+                }
+                pop_back();
+
+                return it;
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto erase(const_iterator first, const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>) -> iterator {
+                DK_ASSERT(first >= cbegin() && first <= cend());
+                DK_ASSERT(last >= first && last <= cend());
+
+                iterator const it_first = begin() + (first - cbegin());
+                iterator const it_last = begin() + (last - cbegin());
+
+                if (it_first == it_last) {
+                    return it_first;
+                }
+
+                if constexpr (is_relocatable) {
+                    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                        for (iterator it = it_first; it != it_last; ++it) {
+                            destroy(it);
+                        }
+                    }
+                    relocate_overlapping(it_first, it_last, static_cast<size_type>(end() - it_last));
+                    self().set_size(self().size() - static_cast<size_type>(it_last - it_first));
+                    return it_first;
+                }
+
+                // NOTE(Dedrick): Move the elements from after the erased range to fill the gap.
+                iterator const new_end = std::move(it_last, end(), it_first);
+
+                // NOTE(Dedrick): The new size is the distance from the beginning to the new end.
+                size_type const new_size = static_cast<size_type>(std::distance(begin(), new_end));
+
+                // NOTE(Dedrick): Destroy the leftover elements at the end and update the size.
+                destruct_and_downsize(new_size);
+
+                return it_first;
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto clear() noexcept -> void {
+                destruct_and_downsize(0);
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto resize(size_type count) -> void {
+                // NOTE(Dedrick): Shrink the vector and deconstruct elements.
+                if (count <= self().size()) {
+                    destruct_and_downsize(count);
+                    return;
+                }
+
+                // NOTE(Dedrick): Default construct new elements.
+                reserve_for(count - self().size());
+                pointer const base = self().data();
+                for (size_type i = self().size(); i < count; ++i) {
+                    construct(base + i);
+                }
+                self().set_size(count);
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto resize(size_type count, value_type const &v) -> void {
+                // NOTE(Dedrick): Shrink the vector and deconstruct elements.
+                if (count <= self().size()) {
+                    destruct_and_downsize(count);
+                    return;
+                }
+
+                // NOTE(Dedrick): Copy construct new elements. Copy v first in case it aliases
+                // an element and growing relocates it.
+                if constexpr (!FixedCapacity) {
+                    if (count > self().capacity()) {
+                        value_type const value(v);
+                        self().grow(count);
+                        resize(count, value);
+                        return;
+                    }
+                }
+                DK_ASSERT(count <= self().capacity()); // Vector is full.
+
+                pointer const base = self().data();
+                for (size_type i = self().size(); i < count; ++i) {
+                    construct(base + i, v);
+                }
+                self().set_size(count);
+            }
+
+        protected:
+            DK_STATIC_VECTOR_CONSTEXPR vector_base() noexcept = default;
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto self() noexcept -> Derived& {
+                return static_cast<Derived&>(*this);
+            }
+
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto self() const noexcept -> Derived const& {
+                return static_cast<Derived const&>(*this);
+            }
+
+            // NOTE(Dedrick): Makes room for count more elements, growing if allowed.
+            DK_STATIC_VECTOR_CONSTEXPR auto reserve_for(size_type count) -> void {
+                if constexpr (FixedCapacity) {
+                    DK_ASSERT(count <= self().capacity() - self().size()); // Vector is full.
+                } else {
+                    if (count > self().capacity() - self().size()) {
+                        self().grow(self().size() + count);
+                    }
+                }
+            }
 
-#include <algorithm>
-#include <cstddef>
-#include <cstdint>
-#include <initializer_list>
-#include <iterator>
-#include <stdexcept>
-#include <type_traits>
-#include <utility>
+            // NOTE(Dedrick): Inserts count elements read from first at index. The tail is
+            // moved exactly once and new elements are constructed or assigned in place.
+            template <typename ForwardIt>
+            DK_STATIC_VECTOR_CONSTEXPR auto insert_forward(size_type index, ForwardIt first, size_type count) -> iterator {
+                if (count == 0) {
+                    return begin() + index;
+                }
 
-#if !defined(DK_ASSERT)
-#   if defined(_MSC_VER)
-#       if !defined(NDEBUG)
-#           include <intrin.h>
-#           define DK_ASSERT(x) do { if (!(x)) { __debugbreak(); } } while(false) /* NOLINT */
-#       else
-#           define DK_ASSERT(x) do { if (!(x)) { (void)(sizeof(x)); } } while(false) /* NOLINT */
-#       endif
-#   else
-#       include <cassert>
-#       define DK_ASSERT(x) assert(x) /* NOLINT */
-#   endif
+                reserve_for(count);
+                size_type const old_size = self().size();
+                size_type const tail = old_size - index;
+                pointer const base = self().data();
+                pointer const p_insert = base + index;
+
+                if constexpr (is_relocatable && std::is_nothrow_constructible_v<value_type, decltype(*first)>) {
+                    relocate_overlapping(p_insert + count, p_insert, tail);
+                    for (size_type i = 0; i < count; ++i, ++first) {
+                        construct(p_insert + i, *first);
+                    }
+                    self().set_size(old_size + count);
+                } else if (count <= tail) {
+                    // NOTE(Dedrick): Move construct the last count elements into the uninitialized
+                    // space, shift the rest of the tail right, then assign over the gap.
+                    for (size_type i = 0; i < count; ++i) {
+                        construct(base + old_size + i, std::move(base[old_size - count + i]));
+                        self().set_size(old_size + i + 1);
+                    }
+                    std::move_backward(p_insert, base + old_size - count, base + old_size);
+                    for (size_type i = 0; i < count; ++i, ++first) {
+                        p_insert[i] = *first;
+                    }
+                } else {
+                    // NOTE(Dedrick): The new elements reach past the old end. Construct the part
+                    // that lands in uninitialized space, move the tail after it, then assign
+                    // the part that overlaps the old tail.
+                    ForwardIt mid = first;
+                    for (size_type i = 0; i < tail; ++i) {
+                        ++mid;
+                    }
+                    for (size_type i = tail; i < count; ++i, ++mid) {
+                        construct(p_insert + i, *mid);
+                        self().set_size(index + i + 1);
+                    }
+                    for (size_type i = 0; i < tail; ++i) {
+                        construct(p_insert + count + i, std::move(p_insert[i]));
+                        self().set_size(index + count + i + 1);
+                    }
+                    for (size_type i = 0; i < tail; ++i, ++first) {
+                        p_insert[i] = *first;
+                    }
+                }
+
+                return p_insert;
+            }
+
+            // NOTE(Dedrick): Bytes that data() is aligned to and readable in whole multiples of,
+            // past size(). Only static_vector pads its storage.
+            [[nodiscard]] static constexpr auto padding() noexcept -> std::size_t {
+                if constexpr (FixedCapacity) {
+                    return Derived::alignment;
+                } else {
+                    return 0;
+                }
+            }
+
+            // NOTE(Dedrick): Index of the first smallest (or largest) element, 0 if empty.
+            template <bool Max>
+            [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto extreme_index() const -> size_type {
+                if (empty()) {
+                    return 0;
+                }
+                if constexpr (is_simd_searchable_v<value_type>) {
+                    if (!is_constant_evaluated()) {
+                        return static_cast<size_type>(simd_extreme<value_type, Max>(self().data(), self().size()));
+                    }
+                }
+                const_iterator const it = Max ? std::max_element(begin(), end()) : std::min_element(begin(), end());
+                return static_cast<size_type>(it - begin());
+            }
+
+            [[nodiscard]] static constexpr auto is_constant_evaluated() noexcept -> bool {
+#if __cplusplus >= 202002L // C++20
+                return std::is_constant_evaluated();
+#else
+                return false;
+#endif
+            }
+
+            template <typename... Args>
+            DK_STATIC_VECTOR_CONSTEXPR static auto construct(pointer p, Args &&...args)
+                noexcept(std::is_nothrow_constructible_v<T, Args...>) -> pointer {
+#if __cplusplus >= 202002L // C++20
+                return std::construct_at(p, std::forward<Args>(args)...);
+#else
+                return new (p) value_type(std::forward<Args>(args)...);
 #endif
+            }
 
-namespace dk {
+            DK_STATIC_VECTOR_CONSTEXPR static auto destroy(pointer p) noexcept -> void {
+#if __cplusplus >= 202002L // C++20
+                std::destroy_at(p);
+#else
+                p->~value_type();
+#endif
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR static auto copy_bytes(pointer dst, const_pointer src, size_type count) noexcept -> void {
+                if (is_constant_evaluated()) {
+                    for (size_type i = 0; i < count; ++i) {
+                        construct(dst + i, src[i]);
+                    }
+                } else if (count != 0) {
+                    std::memcpy(static_cast<void *>(dst), static_cast<void const *>(src), sizeof(value_type) * count);
+                }
+            }
+
+            // NOTE(Dedrick): Moves count elements into uninitialized dst and ends their
+            // lifetime in src. The ranges must not overlap. When a move may throw, every
+            // element is built with move_if_noexcept before any source is destroyed, so a
+            // throw leaves dst empty and src untouched, the strong guarantee of std::vector.
+            DK_STATIC_VECTOR_CONSTEXPR static auto relocate(pointer dst, pointer src, size_type count)
+                noexcept(is_relocatable || std::is_nothrow_move_constructible_v<T>) -> void {
+                if constexpr (is_relocatable) {
+                    if (!is_constant_evaluated()) {
+                        if (count != 0) {
+                            std::memcpy(static_cast<void *>(dst), static_cast<void const *>(src), sizeof(value_type) * count);
+                        }
+                        return;
+                    }
+                }
+                if constexpr (is_relocatable || std::is_nothrow_move_constructible_v<T>) {
+                    for (size_type i = 0; i < count; ++i) {
+                        construct(dst + i, std::move(src[i]));
+                        destroy(src + i);
+                    }
+                } else {
+                    size_type built = 0;
+                    try {
+                        for (; built < count; ++built) {
+                            construct(dst + built, std::move_if_noexcept(src[built]));
+                        }
+                    } catch (...) {
+                        for (size_type i = 0; i < built; ++i) {
+                            destroy(dst + i);
+                        }
+                        throw;
+                    }
+                    for (size_type i = 0; i < count; ++i) {
+                        destroy(src + i);
+                    }
+                }
+            }
+
+            // NOTE(Dedrick): relocate for overlapping ranges of relocatable elements, the
+            // shift behind insert and erase.
+            DK_STATIC_VECTOR_CONSTEXPR static auto relocate_overlapping(pointer dst, pointer src, size_type count) noexcept -> void {
+                static_assert(is_relocatable);
+
+                if (is_constant_evaluated()) {
+                    // NOTE(Dedrick): Walk in the direction that keeps overlapping ranges intact.
+                    if (dst < src) {
+                        for (size_type i = 0; i < count; ++i) {
+                            construct(dst + i, std::move(src[i]));
+                            destroy(src + i);
+                        }
+                    } else {
+                        for (size_type i = count; i > 0; --i) {
+                            construct(dst + i - 1, std::move(src[i - 1]));
+                            destroy(src + i - 1);
+                        }
+                    }
+                } else if (count != 0) {
+                    std::memmove(static_cast<void *>(dst), static_cast<void const *>(src), sizeof(value_type) * count);
+                }
+            }
+
+            DK_STATIC_VECTOR_CONSTEXPR auto destruct_and_downsize(size_type idx) noexcept -> void {
+                DK_ASSERT(idx <= self().size());
+
+                if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                    for (auto it = begin() + idx; it != end(); ++it) {
+                        destroy(it);
+                    }
+                }
+                self().set_size(idx);
+            }
+        };
+
+        template <typename Derived, typename T, typename SizeType, bool FixedCapacity>
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto operator==(
+            vector_base<Derived, T, SizeType, FixedCapacity> const &lhs,
+            vector_base<Derived, T, SizeType, FixedCapacity> const &rhs
+        ) -> bool {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+#if __cplusplus >= 202002L // C++20
+        template <typename Derived, typename T, typename SizeType, bool FixedCapacity>
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto operator<=>(
+            vector_base<Derived, T, SizeType, FixedCapacity> const &lhs,
+            vector_base<Derived, T, SizeType, FixedCapacity> const &rhs
+        ) {
+            return std::lexicographical_compare_three_way(
+                lhs.begin(), lhs.end(),
+                rhs.begin(), rhs.end());
+        }
+#else
+        template <typename Derived, typename T, typename SizeType, bool FixedCapacity>
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto operator!=(
+            vector_base<Derived, T, SizeType, FixedCapacity> const &lhs,
+            vector_base<Derived, T, SizeType, FixedCapacity> const &rhs
+        ) -> bool {
+            return !(lhs == rhs);
+        }
+
+        template <typename Derived, typename T, typename SizeType, bool FixedCapacity>
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto operator<(
+            vector_base<Derived, T, SizeType, FixedCapacity> const &lhs,
+            vector_base<Derived, T, SizeType, FixedCapacity> const &rhs
+        ) -> bool {
+            return std::lexicographical_compare(
+                lhs.begin(), lhs.end(),
+                rhs.begin(), rhs.end());
+        }
+
+        template <typename Derived, typename T, typename SizeType, bool FixedCapacity>
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto operator<=(
+            vector_base<Derived, T, SizeType, FixedCapacity> const &lhs,
+            vector_base<Derived, T, SizeType, FixedCapacity> const &rhs
+        ) -> bool {
+            return !(rhs < lhs);
+        }
+
+        template <typename Derived, typename T, typename SizeType, bool FixedCapacity>
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto operator>(
+            vector_base<Derived, T, SizeType, FixedCapacity> const &lhs,
+            vector_base<Derived, T, SizeType, FixedCapacity> const &rhs
+        ) -> bool {
+            return rhs < lhs;
+        }
+
+        template <typename Derived, typename T, typename SizeType, bool FixedCapacity>
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto operator>=(
+            vector_base<Derived, T, SizeType, FixedCapacity> const &lhs,
+            vector_base<Derived, T, SizeType, FixedCapacity> const &rhs
+        ) -> bool {
+            return !(lhs < rhs);
+        }
+#endif // __cplusplus >= 202002L
+    }
+
+    // NOTE(Dedrick): Removes every element matching pred in one compaction pass.
+    // Returns the number of elements removed.
+    template <typename Derived, typename T, typename SizeType, bool FixedCapacity, typename Pred>
+    DK_STATIC_VECTOR_CONSTEXPR auto erase_if(
+        detail::vector_base<Derived, T, SizeType, FixedCapacity> &vec,
+        Pred pred
+    ) -> SizeType {
+        auto const it = std::remove_if(vec.begin(), vec.end(), pred);
+        auto const count = static_cast<SizeType>(vec.end() - it);
+        vec.erase(it, vec.end());
+        return count;
+    }
+
+    // NOTE(Dedrick): Removes every element equal to value in one compaction pass.
+    // Returns the number of elements removed.
+    template <typename Derived, typename T, typename SizeType, bool FixedCapacity>
+    DK_STATIC_VECTOR_CONSTEXPR auto erase(
+        detail::vector_base<Derived, T, SizeType, FixedCapacity> &vec,
+        typename detail::vector_base<Derived, T, SizeType, FixedCapacity>::value_type const &value
+    ) -> SizeType {
+        if constexpr (std::is_copy_constructible_v<T>) {
+            // NOTE(Dedrick): Compact against a copy when value is an element, since the
+            // pass would overwrite it.
+            std::less<T const *> const less;
+            if (!less(&value, vec.begin()) && less(&value, vec.end())) {
+                T const copy(value);
+                return erase_if(vec, [&copy](T const &e) { return e == copy; });
+            }
+        }
+        return erase_if(vec, [&value](T const &e) { return e == value; });
+    }
+
+    // NOTE(Dedrick): Like erase_if, but each removed element is replaced by one from the
+    // back, so only O(removed) elements move. The order is not kept.
+    template <typename Derived, typename T, typename SizeType, bool FixedCapacity, typename Pred>
+    DK_STATIC_VECTOR_CONSTEXPR auto erase_unordered_if(
+        detail::vector_base<Derived, T, SizeType, FixedCapacity> &vec,
+        Pred pred
+    ) -> SizeType {
+        auto first = vec.begin();
+        auto last = vec.end();
+        while (first != last) {
+            if (pred(*first)) {
+                --last;
+                if (first != last) {
+                    *first = std::move(*last);
+                }
+            } else {
+                ++first;
+            }
+        }
+        auto const count = static_cast<SizeType>(vec.end() - last);
+        vec.erase(last, vec.end());
+        return count;
+    }
+
+    // NOTE(Dedrick): Alignment over-aligns data() and pads the storage to a multiple of that
+    // many bytes, e.g. 32 for AVX2, so whole blocks can be loaded past size() up to
+    // padded_capacity(). The padding is never constructed, lanes past size() must be masked.
     template <
         typename T,
         std::size_t N,
-        typename SizeType = std::uint32_t>
-    class static_vector {
+        typename SizeType = std::uint32_t,
+        std::size_t Alignment = alignof(T)>
+    class static_vector : public detail::vector_base<static_vector<T, N, SizeType, Alignment>, T, SizeType, true> {
+        using base_type = detail::vector_base<static_vector<T, N, SizeType, Alignment>, T, SizeType, true>;
+        friend base_type;
+
     public:
-        using value_type = T;
-        using size_type = SizeType;
-        using reference = value_type&;
-        using const_reference = value_type const&;
-        using pointer = T*;
-        using const_pointer = T const*;
-        using iterator = T*;
-        using const_iterator = T const*;
-        using reverse_iterator = std::reverse_iterator<iterator>;
-        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
-
-        static_assert(std::is_unsigned_v<size_type>); // Must be unsigned integer.
-
-        // NOTE(Dedrick): noexcept(noexcept(expression)) follows this idiom from Raymond Chen.
-        // https://devblogs.microsoft.com/oldnewthing/20220408-00/?p=106438
+        using typename base_type::value_type;
+        using typename base_type::size_type;
+        using typename base_type::reference;
+        using typename base_type::const_reference;
+        using typename base_type::pointer;
+        using typename base_type::const_pointer;
+        using typename base_type::iterator;
+        using typename base_type::const_iterator;
+        using typename base_type::reverse_iterator;
+        using typename base_type::const_reverse_iterator;
+        using base_type::is_trivial;
+        using base_type::is_relocatable;
+
+#if defined(DK_STATIC_VECTOR_COPY_SIZE_ONLY)
+        static constexpr bool is_trivially_copied = false;
+#else
+        static constexpr bool is_trivially_copied = is_trivial;
+#endif
+
+        static constexpr std::size_t alignment = Alignment;
+
+        static_assert((alignment & (alignment - 1)) == 0); // Alignment must be a power of two.
+        static_assert(alignment >= alignof(T)); // Alignment must not weaken alignof(T).
 
     private:
-        alignas(value_type) std::uint8_t m_buffer[sizeof(value_type) * N];
+        static constexpr char const *at_message = "static_vector::at: index out of range";
+
+        static constexpr std::size_t padded_bytes = (N * sizeof(T) + alignment - 1) / alignment * alignment;
+        static constexpr std::size_t padded_count = (padded_bytes + sizeof(T) - 1) / sizeof(T);
+
+        alignas(alignment) detail::uninitialized_array<value_type, padded_count> m_storage;
         size_type m_size;
 
+        using base_type::construct;
+        using base_type::destroy;
+        using base_type::copy_bytes;
+        using base_type::relocate;
+        using base_type::is_constant_evaluated;
+
     public:
-        static_vector() noexcept :
-            m_buffer{ },
+        DK_STATIC_VECTOR_CONSTEXPR static_vector() noexcept :
             m_size{ 0 } { }
 
-        explicit static_vector(size_type count) :
-            m_buffer{ },
+        DK_STATIC_VECTOR_CONSTEXPR explicit static_vector(size_type count) :
             m_size{ count } {
             pointer const base = data();
             for (size_type i = 0; i < count; ++i) {
-                new (base + i) value_type();
+                construct(base + i);
             }
         }
 
-        static_vector(size_type count, value_type const &v) :
-            m_buffer{ },
+        DK_STATIC_VECTOR_CONSTEXPR static_vector(size_type count, value_type const &v) :
             m_size{ count } {
             pointer const base = data();
             for (size_type i = 0; i < count; ++i) {
-                new (base + i) value_type(v);
+                construct(base + i, v);
             }
         }
 
-        static_vector(std::initializer_list<value_type> list) :
-            m_buffer{ },
+        DK_STATIC_VECTOR_CONSTEXPR static_vector(std::initializer_list<value_type> list) :
             m_size{ static_cast<size_type>(list.size()) } {
             pointer const base = data();
             size_type i = 0;
             for (auto it = std::begin(list); it != std::end(list); ++it, ++i) {
-                new (base + i) value_type(*it);
+                construct(base + i, *it);
             }
         }
 
-        ~static_vector() {
+        template <typename InputIt, typename = std::enable_if_t<detail::is_iterator_v<InputIt>>>
+        DK_STATIC_VECTOR_CONSTEXPR static_vector(InputIt first, InputIt last) :
+            m_size{ 0 } {
+            this->insert(this->cend(), first, last);
+        }
+
+#if __cplusplus >= 202002L // C++20
+        // NOTE(Dedrick): Defaulted special members make static_vector trivially copyable
+        // when T is. The copy then covers the whole buffer, a fixed size memcpy, even when
+        // only a few elements are live. DK_STATIC_VECTOR_COPY_SIZE_ONLY opts out.
+        constexpr ~static_vector() requires std::is_trivially_destructible_v<T> = default;
+
+        constexpr static_vector(static_vector const &) requires is_trivially_copied = default;
+
+        constexpr static_vector(static_vector &&) requires is_trivially_copied = default;
+
+        constexpr auto operator=(static_vector const &) -> static_vector& requires is_trivially_copied = default;
+
+        constexpr auto operator=(static_vector &&) -> static_vector& requires is_trivially_copied = default;
+#endif
+
+        DK_STATIC_VECTOR_CONSTEXPR ~static_vector() DK_STATIC_VECTOR_REQUIRES(!std::is_trivially_destructible_v<T>) {
             if constexpr (!std::is_trivially_destructible_v<value_type>) {
-                for (auto it = begin(); it != end(); ++it) {
-                    it->~value_type();
+                for (auto it = this->begin(); it != this->end(); ++it) {
+                    destroy(it);
                 }
             }
         }
 
-        static_vector(static_vector const &rhs) :
-            m_buffer{ },
+        DK_STATIC_VECTOR_CONSTEXPR static_vector(static_vector const &rhs) DK_STATIC_VECTOR_REQUIRES(!is_trivially_copied) :
             m_size{ rhs.size() } {
             size_type const count = rhs.size();
-            pointer const base = data();
-            for (size_type i = 0; i < count; ++i) {
-                new (base + i) value_type(rhs[i]);
+            if constexpr (is_trivial) {
+                copy_bytes(data(), rhs.data(), count);
+            } else {
+                pointer const base = data();
+                for (size_type i = 0; i < count; ++i) {
+                    construct(base + i, rhs[i]);
+                }
             }
         }
 
-        static_vector(static_vector &&rhs) noexcept(std::is_nothrow_move_constructible_v<T>) :
-            m_buffer{ },
+        DK_STATIC_VECTOR_CONSTEXPR static_vector(static_vector &&rhs) noexcept(std::is_nothrow_move_constructible_v<T>) DK_STATIC_VECTOR_REQUIRES(!is_trivially_copied) :
             m_size{ rhs.size() } {
             size_type const count = rhs.size();
-            pointer const base = data();
-            for (size_type i = 0; i < count; ++i) {
-                new (base + i) value_type(std::move(rhs[i]));
+            if constexpr (is_trivial) {
+                // NOTE(Dedrick): Moving a trivially copyable value leaves the source as is.
+                copy_bytes(data(), rhs.data(), count);
+            } else if constexpr (is_relocatable) {
+                relocate(data(), rhs.data(), count);
+                rhs.m_size = 0;
+            } else {
+                pointer const base = data();
+                for (size_type i = 0; i < count; ++i) {
+                    construct(base + i, std::move(rhs[i]));
+                }
+                rhs.clear();
+            }
+        }
+
+        DK_STATIC_VECTOR_CONSTEXPR auto operator=(static_vector const &rhs) -> static_vector& DK_STATIC_VECTOR_REQUIRES(!is_trivially_copied) {
+            if (this != &rhs) {
+                if constexpr (is_trivial) {
+                    copy_bytes(data(), rhs.data(), rhs.size());
+                    m_size = rhs.size();
+                } else {
+                    static_vector tmp(rhs);
+                    this->swap(tmp);
+                }
             }
-            rhs.clear();
+            return *this;
         }
 
-        auto operator=(static_vector tmp)
+        DK_STATIC_VECTOR_CONSTEXPR auto operator=(static_vector &&rhs)
             noexcept(
                 std::is_nothrow_move_constructible_v<T> &&
-                std::is_nothrow_swappable_v<T>) -> static_vector& {
-            this->swap(tmp);
+                std::is_nothrow_swappable_v<T>) -> static_vector& DK_STATIC_VECTOR_REQUIRES(!is_trivially_copied) {
+            if (this != &rhs) {
+                if constexpr (is_trivial) {
+                    copy_bytes(data(), rhs.data(), rhs.size());
+                    m_size = rhs.size();
+                } else {
+                    static_vector tmp(std::move(rhs));
+                    this->swap(tmp);
+                }
+            }
             return *this;
         }
 
-        auto swap(static_vector &rhs)
+        DK_STATIC_VECTOR_CONSTEXPR auto swap(static_vector &rhs)
             noexcept(
                 std::is_nothrow_move_constructible_v<T> &&
                 std::is_nothrow_swappable_v<T>) -> void {
+            if constexpr (is_relocatable) {
+                if (!is_constant_evaluated()) {
+                    // NOTE(Dedrick): Swap the bytes of the live elements only, through a small
+                    // bounce buffer so the stack cost does not grow with N.
+                    size_type const max_size = size() < rhs.size() ? rhs.size() : size();
+                    std::size_t const bytes = static_cast<std::size_t>(max_size) * sizeof(value_type);
+                    auto *const lhs_bytes = reinterpret_cast<unsigned char *>(data());
+                    auto *const rhs_bytes = reinterpret_cast<unsigned char *>(rhs.data());
+                    unsigned char tmp[256];
+                    for (std::size_t offset = 0; offset < bytes; offset += sizeof(tmp)) {
+                        std::size_t const chunk = bytes - offset < sizeof(tmp) ? bytes - offset : sizeof(tmp);
+                        std::memcpy(tmp, lhs_bytes + offset, chunk);
+                        std::memcpy(lhs_bytes + offset, rhs_bytes + offset, chunk);
+                        std::memcpy(rhs_bytes + offset, tmp, chunk);
+                    }
+                    std::swap(m_size, rhs.m_size);
+                    return;
+                }
+            }
+
             // NOTE(Dedrick): Since both vectors have their own buffers, a full swap involves
             // element-wise swapping up to the minimum size, then moving the rest.
 
@@ -158,11 +1726,11 @@ namespace dk {
             // NOTE(Dedrick): Move construct the tail elements.
             if (lhs_size < rhs_size) {
                 for (size_type i = lhs_size; i < rhs_size; ++i) {
-                    new (lhs_base + i) value_type(std::move(rhs_base[i]));
+                    construct(lhs_base + i, std::move(rhs_base[i]));
                 }
             } else if (lhs_size > rhs_size) {
                 for (size_type i = rhs_size; i < lhs_size; ++i) {
-                    new (rhs_base + i) value_type(std::move(lhs_base[i]));
+                    construct(rhs_base + i, std::move(lhs_base[i]));
                 }
             }
 
@@ -170,361 +1738,375 @@ namespace dk {
             std::swap(m_size, rhs.m_size);
         }
 
-        [[nodiscard]] auto begin() noexcept -> iterator {
-            return iterator{ data() };
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto size() const noexcept -> size_type {
+            return m_size;
         }
 
-        [[nodiscard]] auto end() noexcept -> iterator {
-            return iterator{ data() + size()};
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto max_size() const noexcept -> size_type {
+            return static_cast<size_type>(N);
         }
 
-        [[nodiscard]] auto begin() const noexcept -> const_iterator {
-            return const_iterator{ data() };
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto capacity() const noexcept -> size_type {
+            return static_cast<size_type>(N);
         }
 
-        [[nodiscard]] auto end() const noexcept -> const_iterator {
-            return const_iterator{ data() + size() };
+        // NOTE(Dedrick): Number of slots readable from data(), capacity() rounded up to a whole
+        // multiple of alignment bytes. Only the first size() hold elements.
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto padded_capacity() const noexcept -> size_type {
+            return static_cast<size_type>(padded_count);
         }
 
-        [[nodiscard]] auto cbegin() const noexcept -> const_iterator {
-            return const_iterator{ begin() };
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto data() noexcept -> pointer {
+            return m_storage.m_data;
         }
 
-        [[nodiscard]] auto cend() const noexcept -> const_iterator {
-            return const_iterator{ end() };
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto data() const noexcept -> const_pointer {
+            return m_storage.m_data;
         }
 
-        [[nodiscard]] auto rbegin() noexcept -> reverse_iterator {
-            return std::reverse_iterator<iterator>{ end() };
+    private:
+        DK_STATIC_VECTOR_CONSTEXPR auto set_size(size_type count) noexcept -> void {
+            m_size = count;
         }
+    };
 
-        [[nodiscard]] auto rend() noexcept -> reverse_iterator {
-            return std::reverse_iterator<iterator>{ begin() };
-        }
+    template <
+        typename T,
+        std::size_t N,
+        typename Allocator = std::allocator<T>,
+        typename SizeType = std::uint32_t>
+    class small_vector : public detail::vector_base<small_vector<T, N, Allocator, SizeType>, T, SizeType, false> {
+        using base_type = detail::vector_base<small_vector<T, N, Allocator, SizeType>, T, SizeType, false>;
+        using alloc_traits = std::allocator_traits<Allocator>;
+        friend base_type;
 
-        [[nodiscard]] auto rbegin() const noexcept -> const_reverse_iterator {
-            return std::reverse_iterator<const_reverse_iterator>{ end() };
-        }
+    public:
+        using typename base_type::value_type;
+        using typename base_type::size_type;
+        using typename base_type::reference;
+        using typename base_type::const_reference;
+        using typename base_type::pointer;
+        using typename base_type::const_pointer;
+        using typename base_type::iterator;
+        using typename base_type::const_iterator;
+        using typename base_type::reverse_iterator;
+        using typename base_type::const_reverse_iterator;
+        using base_type::is_trivial;
+        using base_type::is_relocatable;
+        using allocator_type = Allocator;
+
+        static_assert(N > 0); // Use std::vector for no inline capacity.
+        static_assert(std::is_same_v<typename alloc_traits::value_type, T>); // Allocator must allocate T.
+        static_assert(std::is_same_v<typename alloc_traits::pointer, T*>); // Allocator must return raw pointers.
 
-        [[nodiscard]] auto rend() const noexcept -> const_reverse_iterator {
-            return std::reverse_iterator<const_reverse_iterator>{ begin() };
-        }
+    private:
+        static constexpr char const *at_message = "small_vector::at: index out of range";
 
-        [[nodiscard]] auto crbegin() const noexcept -> const_reverse_iterator {
-            return std::reverse_iterator<const_iterator>{ end() };
-        }
+        // NOTE(Dedrick): The allocator is a base of the heap pointer so an empty one takes
+        // no space. m_data is null while the elements are stored inline.
+        struct heap_type : Allocator {
+            pointer m_data;
 
-        [[nodiscard]] auto crend() const noexcept -> const_reverse_iterator {
-            return std::reverse_iterator<const_iterator>{ begin() };
-        }
+            DK_STATIC_VECTOR_CONSTEXPR explicit heap_type(Allocator const &alloc) noexcept :
+                Allocator(alloc),
+                m_data{ nullptr } { }
+        };
 
-        [[nodiscard]] auto empty() const noexcept -> bool {
-            return m_size == 0;
-        }
+        heap_type m_heap;
+        size_type m_size;
+        size_type m_capacity;
+        detail::uninitialized_array<value_type, N> m_storage;
 
-        [[nodiscard]] auto size() const noexcept -> size_type {
-            return m_size;
-        }
+        using base_type::construct;
+        using base_type::copy_bytes;
+        using base_type::relocate;
+        using base_type::destruct_and_downsize;
 
-        [[nodiscard]] auto max_size() const noexcept -> size_type {
-            return static_cast<size_type>(N);
+    public:
+        DK_STATIC_VECTOR_CONSTEXPR small_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) :
+            m_heap{ Allocator() },
+            m_size{ 0 },
+            m_capacity{ static_cast<size_type>(N) } { }
+
+        DK_STATIC_VECTOR_CONSTEXPR explicit small_vector(Allocator const &alloc) noexcept :
+            m_heap{ alloc },
+            m_size{ 0 },
+            m_capacity{ static_cast<size_type>(N) } { }
+
+        DK_STATIC_VECTOR_CONSTEXPR explicit small_vector(size_type count, Allocator const &alloc = Allocator()) :
+            small_vector(alloc) {
+            this->resize(count);
         }
 
-        [[nodiscard]] auto capacity() const noexcept -> size_type {
-            return static_cast<size_type>(N);
+        DK_STATIC_VECTOR_CONSTEXPR small_vector(size_type count, value_type const &v, Allocator const &alloc = Allocator()) :
+            small_vector(alloc) {
+            this->resize(count, v);
         }
 
-        [[nodiscard]] auto front() noexcept -> reference {
-            DK_ASSERT(!empty()); // front() called for empty array.
-
-            return *begin();
+        DK_STATIC_VECTOR_CONSTEXPR small_vector(std::initializer_list<value_type> list, Allocator const &alloc = Allocator()) :
+            small_vector(alloc) {
+            reserve(static_cast<size_type>(list.size()));
+            pointer const base = data();
+            size_type i = 0;
+            for (auto it = std::begin(list); it != std::end(list); ++it, ++i) {
+                construct(base + i, *it);
+            }
+            m_size = i;
         }
 
-        [[nodiscard]] auto front() const noexcept -> const_reference {
-            DK_ASSERT(!empty()); // front() called for empty array.
-
-            return *begin();
+        template <typename InputIt, typename = std::enable_if_t<detail::is_iterator_v<InputIt>>>
+        DK_STATIC_VECTOR_CONSTEXPR small_vector(InputIt first, InputIt last, Allocator const &alloc = Allocator()) :
+            small_vector(alloc) {
+            this->insert(this->cend(), first, last);
         }
 
-        [[nodiscard]] auto back() noexcept -> reference {
-            DK_ASSERT(!empty()); // back() called for empty array.
-
-            return *(end() - 1);
+        DK_STATIC_VECTOR_CONSTEXPR ~small_vector() {
+            destruct_and_downsize(0);
+            release();
         }
 
-        [[nodiscard]] auto back() const noexcept -> const_reference {
-            DK_ASSERT(!empty()); // back() called for empty array.
-
-            return *(end() - 1);
+        DK_STATIC_VECTOR_CONSTEXPR small_vector(small_vector const &rhs) :
+            small_vector(alloc_traits::select_on_container_copy_construction(rhs.get_allocator())) {
+            copy_from(rhs);
         }
 
-        [[nodiscard]] auto data() noexcept -> pointer {
-            return reinterpret_cast<pointer>(m_buffer);
+        DK_STATIC_VECTOR_CONSTEXPR small_vector(small_vector &&rhs) noexcept(std::is_nothrow_move_constructible_v<T>) :
+            small_vector(rhs.get_allocator()) {
+            take_from(rhs);
         }
 
-        [[nodiscard]] auto data() const noexcept -> const_pointer {
-            return reinterpret_cast<const_pointer>(m_buffer);
+        DK_STATIC_VECTOR_CONSTEXPR auto operator=(small_vector const &rhs) -> small_vector& {
+            if (this != &rhs) {
+                this->clear();
+                copy_from(rhs);
+            }
+            return *this;
         }
 
-        auto operator[](size_type idx) noexcept -> reference {
-            DK_ASSERT(idx < size()); // Out of bounds.
-
-            return data()[idx];
+        // NOTE(Dedrick): Only an allocator that may compare unequal can make a move allocate.
+        DK_STATIC_VECTOR_CONSTEXPR auto operator=(small_vector &&rhs)
+            noexcept(
+                std::is_nothrow_move_constructible_v<T> &&
+                alloc_traits::is_always_equal::value) -> small_vector& {
+            if (this != &rhs) {
+                this->clear();
+                if (rhs.m_heap.m_data != nullptr && !allocator_equal(rhs)) {
+                    // NOTE(Dedrick): Memory from an unequal allocator cannot be adopted.
+                    reserve(rhs.size());
+                    relocate(data(), rhs.data(), rhs.size());
+                    m_size = rhs.size();
+                    rhs.m_size = 0;
+                } else {
+                    release();
+                    take_from(rhs);
+                }
+            }
+            return *this;
         }
 
-        auto operator[](size_type idx) const noexcept -> const_reference {
-            DK_ASSERT(idx < size()); // Out of bounds.
-
-            return data()[idx];
-        }
+        DK_STATIC_VECTOR_CONSTEXPR auto swap(small_vector &rhs)
+            noexcept(
+                std::is_nothrow_move_constructible_v<T> &&
+                std::is_nothrow_swappable_v<T> &&
+                alloc_traits::is_always_equal::value) -> void {
+            if (this == &rhs) {
+                return;
+            }
+            bool const lhs_heap = m_heap.m_data != nullptr;
+            bool const rhs_heap = rhs.m_heap.m_data != nullptr;
+            if ((lhs_heap || rhs_heap) && !allocator_equal(rhs)) {
+                // NOTE(Dedrick): Memory from an unequal allocator cannot change hands.
+                small_vector tmp(std::move(rhs));
+                rhs = std::move(*this);
+                *this = std::move(tmp);
+                return;
+            }
 
-        auto at(size_type idx) -> reference {
-            if (idx >= m_size) {
-                throw std::out_of_range("static_vector::at: index out of range");
+            if (lhs_heap && rhs_heap) {
+                std::swap(m_heap.m_data, rhs.m_heap.m_data);
+            } else if (lhs_heap) {
+                // NOTE(Dedrick): The inline buffer of a heap vector is free, so the inline
+                // elements move across once and the heap pointer changes hands.
+                relocate(m_storage.m_data, rhs.m_storage.m_data, rhs.m_size);
+                rhs.m_heap.m_data = m_heap.m_data;
+                m_heap.m_data = nullptr;
+            } else if (rhs_heap) {
+                relocate(rhs.m_storage.m_data, m_storage.m_data, m_size);
+                m_heap.m_data = rhs.m_heap.m_data;
+                rhs.m_heap.m_data = nullptr;
+            } else {
+                // NOTE(Dedrick): Swap the common elements, then relocate the longer tail.
+                size_type const min_size = m_size < rhs.m_size ? m_size : rhs.m_size;
+                for (size_type i = 0; i < min_size; ++i) {
+                    std::swap(m_storage.m_data[i], rhs.m_storage.m_data[i]);
+                }
+                if (m_size < rhs.m_size) {
+                    relocate(m_storage.m_data + min_size, rhs.m_storage.m_data + min_size, rhs.m_size - min_size);
+                } else {
+                    relocate(rhs.m_storage.m_data + min_size, m_storage.m_data + min_size, m_size - min_size);
+                }
             }
-            return data()[idx];
+            std::swap(m_size, rhs.m_size);
+            std::swap(m_capacity, rhs.m_capacity);
         }
 
-        auto at(size_type idx) const -> const_reference {
-            if (idx >= m_size) {
-                throw std::out_of_range("static_vector::at: index out of range");
-            }
-            return data()[idx];
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto size() const noexcept -> size_type {
+            return m_size;
         }
 
-        auto push_back(value_type const &v) -> void {
-            DK_ASSERT(size() < N); // Vector is full.
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto max_size() const noexcept -> size_type {
+            std::size_t const alloc_max = alloc_traits::max_size(allocator());
+            std::size_t const size_max = std::numeric_limits<size_type>::max();
+            return static_cast<size_type>(alloc_max < size_max ? alloc_max : size_max);
+        }
 
-            emplace_back(v);
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto capacity() const noexcept -> size_type {
+            return m_capacity;
         }
 
-        auto push_back(value_type &&v) noexcept(noexcept(value_type(std::move(v)))) -> void {
-            DK_ASSERT(size() < N); // Vector is full.
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto inline_capacity() const noexcept -> size_type {
+            return static_cast<size_type>(N);
+        }
 
-            emplace_back(std::move(v));
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto is_inline() const noexcept -> bool {
+            return m_heap.m_data == nullptr;
         }
 
-        template <typename... Args>
-        auto emplace_back(Args &&...args) noexcept(noexcept(value_type(std::forward<Args>(args)...))) -> reference {
-            DK_ASSERT(size() < N); // Vector is full.
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto data() noexcept -> pointer {
+            return m_heap.m_data != nullptr ? m_heap.m_data : m_storage.m_data;
+        }
 
-            pointer const base = data();
-            pointer const ptr = new (base + m_size++) value_type(std::forward<Args>(args)...);
-            return *ptr;
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto data() const noexcept -> const_pointer {
+            return m_heap.m_data != nullptr ? m_heap.m_data : m_storage.m_data;
         }
 
-        auto pop_back() noexcept -> void {
-            DK_ASSERT(!empty()); // pop_back() called for empty array.
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto get_allocator() const noexcept -> allocator_type {
+            return allocator();
+        }
 
-            size_type const new_size = size() - 1;
-            if constexpr (!std::is_trivially_destructible_v<value_type>) {
-                data()[new_size].~value_type();
+        DK_STATIC_VECTOR_CONSTEXPR auto reserve(size_type new_capacity) -> void {
+            if (new_capacity > m_capacity) {
+                reallocate(new_capacity);
             }
-            m_size = new_size;
         }
 
-        template <typename... Args>
-        auto emplace(const_iterator pos, Args &&...args)
-            noexcept(
-                std::is_nothrow_constructible_v<T, Args...> &&
-                std::is_nothrow_move_constructible_v<T> &&
-                std::is_nothrow_move_assignable_v<T>) -> iterator {
-            DK_ASSERT(size() < N); // Vector is full.
-            DK_ASSERT(pos >= cbegin() && pos <= cend()); // Iterator out of bounds.
-
-            const size_type index = pos - cbegin();
-            pointer p_insert = data() + index;
-
-            if (index < m_size) {
-                // NOTE(Dedrick): Not inserting at the end, so we need to make space.
-                // Move construct the last element into the uninitialized space at the new end.
-                new (end()) value_type(std::move(back()));
-
-                // NOTE(Dedrick): Shift existing elements one position to the right.
-                for (iterator it = end() - 1; it > p_insert; --it) {
-                    *it = std::move(*(it - 1));
-                }
-
-                // NOTE(Dedrick): Assign the new value to the now moved-from object at the insertion point.
-                *p_insert = value_type(std::forward<Args>(args)...);
+        // NOTE(Dedrick): Moves the elements back inline when they fit.
+        DK_STATIC_VECTOR_CONSTEXPR auto shrink_to_fit() -> void {
+            if (m_heap.m_data == nullptr || m_size == m_capacity) {
+                return;
+            }
+            if (m_size <= N) {
+                pointer const heap = m_heap.m_data;
+                relocate(m_storage.m_data, heap, m_size);
+                alloc_traits::deallocate(allocator(), heap, m_capacity);
+                m_heap.m_data = nullptr;
+                m_capacity = static_cast<size_type>(N);
             } else {
-                // NOTE(Dedrick): Inserting at the end is just emplace_back.
-                new (p_insert) value_type(std::forward<Args>(args)...);
+                reallocate(m_size);
             }
-
-            ++m_size;
-            return p_insert;
         }
 
-        auto insert(const_iterator pos, value_type const &value)
-            noexcept(
-                std::is_nothrow_copy_constructible_v<T> &&
-                std::is_nothrow_move_constructible_v<T> &&
-                std::is_nothrow_move_assignable_v<T>) -> iterator {
-            return emplace(pos, value);
+    private:
+        DK_STATIC_VECTOR_CONSTEXPR auto set_size(size_type count) noexcept -> void {
+            m_size = count;
         }
 
-        auto insert(const_iterator pos, value_type &&value)
-            noexcept(
-                std::is_nothrow_move_constructible_v<T> &&
-                std::is_nothrow_move_assignable_v<T>) -> iterator {
-            return emplace(pos, std::move(value));
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto allocator() noexcept -> Allocator& {
+            return m_heap;
         }
 
-        auto erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) -> iterator {
-            DK_ASSERT(!empty());
-            DK_ASSERT(pos >= cbegin() && pos < cend());
-
-            // NOTE(Dedrick): Convert const_iterator to a mutable iterator.
-            iterator const it = begin() + (pos - cbegin());
-
-            // NOTE(Dedrick): Shift all elements after this one to the left.
-            std::move(it + 1, end(), it);
-
-            // NOTE(Dedrick): Destroy the now-duplicate last element and shrink the vector.
-            pop_back();
-
-            return it;
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto allocator() const noexcept -> Allocator const& {
+            return m_heap;
         }
 
-        auto erase(const_iterator first, const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>) -> iterator {
-            DK_ASSERT(first >= cbegin() && first <= cend());
-            DK_ASSERT(last >= first && last <= cend());
-
-            iterator const it_first = begin() + (first - cbegin());
-            iterator const it_last = begin() + (last - cbegin());
-
-            if (it_first == it_last) {
-                return it_first;
+        // NOTE(Dedrick): Geometric growth keeps push_back amortized O(1).
+        DK_STATIC_VECTOR_CONSTEXPR auto grow(size_type min_capacity) -> void {
+            size_type const limit = max_size();
+            if (min_capacity > limit) {
+                throw std::length_error("small_vector: capacity exceeds max_size()");
             }
-
-            // NOTE(Dedrick): Move the elements from after the erased range to fill the gap.
-            iterator const new_end = std::move(it_last, end(), it_first);
-
-            // NOTE(Dedrick): The new size is the distance from the beginning to the new end.
-            size_type const new_size = std::distance(begin(), new_end);
-
-            // NOTE(Dedrick): Destroy the leftover elements at the end and update the size.
-            destruct_and_downsize(new_size);
-
-            return it_first;
-        }
-
-        auto clear() noexcept -> void {
-            destruct_and_downsize(0);
+            size_type const doubled = m_capacity > limit / 2 ? limit : static_cast<size_type>(m_capacity * 2);
+            reallocate(doubled < min_capacity ? min_capacity : doubled);
         }
 
-        auto resize(size_type count) -> void {
-            // NOTE(Dedrick): Shrink the vector and deconstruct elements.
-            if (count <= size()) {
-                destruct_and_downsize(count);
-                return;
-            }
+        DK_STATIC_VECTOR_CONSTEXPR auto reallocate(size_type new_capacity) -> void {
+            DK_ASSERT(new_capacity >= m_size);
 
-            // NOTE(Dedrick): Default construct new elements.
-            pointer const base = data();
-            for (size_type i = size(); i < count; ++i) {
-                new (base + i) value_type();
+            pointer const heap = alloc_traits::allocate(allocator(), new_capacity);
+            if constexpr (is_relocatable || std::is_nothrow_move_constructible_v<T>) {
+                relocate(heap, data(), m_size);
+            } else {
+                try {
+                    relocate(heap, data(), m_size);
+                } catch (...) {
+                    alloc_traits::deallocate(allocator(), heap, new_capacity);
+                    throw;
+                }
             }
-            m_size = count;
+            release();
+            m_heap.m_data = heap;
+            m_capacity = new_capacity;
         }
 
-        auto resize(size_type count, value_type const &v) -> void {
-            // NOTE(Dedrick): Shrink the vector and deconstruct elements.
-            if (count <= size()) {
-                destruct_and_downsize(count);
-                return;
+        DK_STATIC_VECTOR_CONSTEXPR auto release() noexcept -> void {
+            if (m_heap.m_data != nullptr) {
+                alloc_traits::deallocate(allocator(), m_heap.m_data, m_capacity);
+                m_heap.m_data = nullptr;
+                m_capacity = static_cast<size_type>(N);
             }
+        }
 
-            // NOTE(Dedrick): Default construct new elements.
-            pointer const base = data();
-            for (size_type i = size(); i < count; ++i) {
-                new (base + i) value_type(v);
+        [[nodiscard]] DK_STATIC_VECTOR_CONSTEXPR auto allocator_equal(small_vector const &rhs) const noexcept -> bool {
+            if constexpr (alloc_traits::is_always_equal::value) {
+                return true;
+            } else {
+                return allocator() == rhs.allocator();
             }
-            m_size = count;
         }
 
-    private:
-        auto destruct_and_downsize(std::size_t idx) noexcept -> void {
-            DK_ASSERT(idx <= size());
-
-            if constexpr (!std::is_trivially_destructible_v<value_type>) {
-                for (auto it = begin() + idx; it != end(); ++it) {
-                    it->~value_type();
+        // NOTE(Dedrick): Expects this to be empty.
+        DK_STATIC_VECTOR_CONSTEXPR auto copy_from(small_vector const &rhs) -> void {
+            reserve(rhs.size());
+            if constexpr (is_trivial) {
+                copy_bytes(data(), rhs.data(), rhs.size());
+            } else {
+                pointer const base = data();
+                for (size_type i = 0; i < rhs.size(); ++i) {
+                    construct(base + i, rhs[i]);
+                    m_size = i + 1;
                 }
             }
-            m_size = idx;
+            m_size = rhs.size();
         }
-    };
 
-    template <typename T, std::size_t N, typename SizeType>
-    [[nodiscard]] auto operator==(
-        static_vector<T, N, SizeType> const &lhs,
-        static_vector<T, N, SizeType> const &rhs
-    ) -> bool {
-        if (lhs.size() != rhs.size()) {
-            return false;
+        // NOTE(Dedrick): Expects this to be empty and inline. Heap memory is adopted,
+        // inline elements are relocated. rhs is left empty.
+        DK_STATIC_VECTOR_CONSTEXPR auto take_from(small_vector &rhs) noexcept(std::is_nothrow_move_constructible_v<T>) -> void {
+            if (rhs.m_heap.m_data != nullptr) {
+                m_heap.m_data = rhs.m_heap.m_data;
+                m_capacity = rhs.m_capacity;
+                rhs.m_heap.m_data = nullptr;
+                rhs.m_capacity = static_cast<size_type>(N);
+            } else {
+                relocate(m_storage.m_data, rhs.m_storage.m_data, rhs.m_size);
+            }
+            m_size = rhs.m_size;
+            rhs.m_size = 0;
         }
-        return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
-    }
-
-#if __cplusplus >= 202002L // C++20
-    template <typename T, std::size_t N, typename SizeType>
-    [[nodiscard]] auto operator<=>(
-        static_vector<T, N, SizeType> const &lhs,
-        static_vector<T, N, SizeType> const &rhs
-    ) {
-        return std::lexicographical_compare_three_way(
-            std::begin(lhs), std::end(lhs),
-            std::begin(rhs), std::end(rhs));
-    }
-#else
-    template <typename T, std::size_t N, typename SizeType>
-    [[nodiscard]] auto operator!=(
-        static_vector<T, N, SizeType> const &lhs,
-        static_vector<T, N, SizeType> const &rhs
-    ) -> bool {
-        return !(lhs == rhs);
-    }
-
-    template <typename T, std::size_t N, typename SizeType>
-    [[nodiscard]] auto operator<(
-        static_vector<T, N, SizeType> const &lhs,
-        static_vector<T, N, SizeType> const &rhs
-    ) -> bool {
-        return std::lexicographical_compare(
-            std::begin(lhs), std::end(lhs),
-            std::begin(rhs), std::end(rhs));
-    }
-
-    template <typename T, std::size_t N, typename SizeType>
-    [[nodiscard]] auto operator<=(
-        static_vector<T, N, SizeType> const &lhs,
-        static_vector<T, N, SizeType> const &rhs
-    ) -> bool {
-        return !(rhs < lhs);
-    }
-
-    template <typename T, std::size_t N, typename SizeType>
-    [[nodiscard]] auto operator>(
-        static_vector<T, N, SizeType> const &lhs,
-        static_vector<T, N, SizeType> const &rhs
-    ) -> bool {
-        return rhs < lhs;
-    }
-
-    template <typename T, std::size_t N, typename SizeType>
-    [[nodiscard]] auto operator>=(
-        static_vector<T, N, SizeType> const &lhs,
-        static_vector<T, N, SizeType> const &rhs
-    ) -> bool {
-        return !(lhs < rhs);
-    }
-#endif // __cplusplus >= 202002L
+    };
 }
 
 /**
  * Revision History:
+ *     0.10 (2026-10-18) add Alignment parameter and padded_capacity to static_vector;
+ *     0.9 (2026-10-18) add SSE2/AVX2 find, count, contains, index_of, min_element and max_element;
+ *     0.8 (2026-10-18) add is_trivially_relocatable, relocate with memmove in insert, erase and swap;
+ *     0.7 (2026-10-18) add erase_unordered, erase, erase_if and erase_unordered_if;
+ *     0.6 (2026-10-18) add try_emplace_back, try_append_range and unchecked_emplace_back;
+ *     0.5 (2026-10-18) add range insert, assign, append_range and iterator constructors;
+ *     0.4 (2026-10-18) add small_vector, share implementation with static_vector;
+ *     0.3 (2026-10-18) union storage, constexpr in C++20;
+ *     0.2 (2026-10-18) skip buffer zeroing, add trivially copyable fast paths;
  *     0.1 (2025-09-27) first version;
  */
 